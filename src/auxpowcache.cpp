@@ -0,0 +1,71 @@
+// Copyright (c) 2024 The Junkcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <auxpowcache.h>
+
+#include <auxpow.h>
+#include <serialize.h>
+#include <version.h>
+
+CAuxPowCache g_auxpow_cache;
+
+void CAuxPowCache::SetMaxSize(size_t max_bytes)
+{
+    LOCK(m_mutex);
+    m_max_bytes = max_bytes;
+    Evict();
+}
+
+std::shared_ptr<CAuxPow> CAuxPowCache::Get(const uint256& hash)
+{
+    LOCK(m_mutex);
+    auto it = m_entries.find(hash);
+    if (it == m_entries.end()) return nullptr;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->auxpow;
+}
+
+void CAuxPowCache::Insert(const uint256& hash, std::shared_ptr<CAuxPow> auxpow)
+{
+    if (!auxpow) return;
+    // Serialized size plus the list node and map bucket overhead
+    const size_t bytes = ::GetSerializeSize(*auxpow, PROTOCOL_VERSION) + sizeof(Entry) + 64;
+
+    LOCK(m_mutex);
+    if (bytes > m_max_bytes) return;
+    auto it = m_entries.find(hash);
+    if (it != m_entries.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return;
+    }
+    m_lru.push_front(Entry{hash, std::move(auxpow), bytes});
+    m_entries.emplace(hash, m_lru.begin());
+    m_bytes += bytes;
+    Evict();
+}
+
+void CAuxPowCache::Clear()
+{
+    LOCK(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_bytes = 0;
+}
+
+size_t CAuxPowCache::Size() const
+{
+    LOCK(m_mutex);
+    return m_bytes;
+}
+
+void CAuxPowCache::Evict()
+{
+    AssertLockHeld(m_mutex);
+    while (m_bytes > m_max_bytes && !m_lru.empty()) {
+        const Entry& oldest = m_lru.back();
+        m_bytes -= oldest.bytes;
+        m_entries.erase(oldest.hash);
+        m_lru.pop_back();
+    }
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2024 The Junkcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_AUXPOWCACHE_H
+#define BITCOIN_AUXPOWCACHE_H
+
+#include <crypto/common.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+class CAuxPow;
+
+/** Default for -auxpowcache, the memory limit of the auxpow header cache in MiB */
+static const int64_t DEFAULT_AUXPOW_CACHE_SIZE = 32;
+
+/**
+ * Least-recently-used cache of the auxpow of block headers, keyed by block
+ * hash. CBlockIndex does not keep the auxpow, so without this cache every
+ * auxpow header served through getheaders, REST or RPC is read back from the
+ * block files. Only auxpow that has passed validation is inserted.
+ */
+class CAuxPowCache
+{
+public:
+    explicit CAuxPowCache(size_t max_bytes = DEFAULT_AUXPOW_CACHE_SIZE << 20) : m_max_bytes(max_bytes) {}
+
+    /** Change the memory limit, evicting entries as needed. */
+    void SetMaxSize(size_t max_bytes);
+
+    /** Return the cached auxpow of a block, or nullptr. */
+    std::shared_ptr<CAuxPow> Get(const uint256& hash);
+
+    void Insert(const uint256& hash, std::shared_ptr<CAuxPow> auxpow);
+
+    void Clear();
+
+    /** Approximate memory used by the cached entries, in bytes. */
+    size_t Size() const;
+
+private:
+    struct Entry {
+        uint256 hash;
+        std::shared_ptr<CAuxPow> auxpow;
+        size_t bytes;
+    };
+
+    struct Hasher {
+        // Block hashes are already uniformly distributed.
+        size_t operator()(const uint256& hash) const { return ReadLE64(hash.begin()); }
+    };
+
+    void Evict() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+    mutable Mutex m_mutex;
+    //! Most recently used entries first
+    std::list<Entry> m_lru GUARDED_BY(m_mutex);
+    std::unordered_map<uint256, std::list<Entry>::iterator, Hasher> m_entries GUARDED_BY(m_mutex);
+    size_t m_bytes GUARDED_BY(m_mutex){0};
+    size_t m_max_bytes GUARDED_BY(m_mutex);
+};
+
+/** Auxpow of recently accepted or served block headers */
+extern CAuxPowCache g_auxpow_cache;
+
+#endif // BITCOIN_AUXPOWCACHE_H
@@ -0,0 +1,57 @@
+// Copyright (c) 2021 The Junkcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <test/util/setup_common.h>
+
+#include <mw/crypto/Bulletproofs.h>
+#include <mw/crypto/Schnorr.h>
+#include <mw/crypto/VerificationCache.h>
+#include <mw/models/tx/TxBody.h>
+#include <mw/node/BlockValidator.h>
+
+#include <test_framework/Miner.h>
+
+// Validates a synthetic MWEB block with 50 pegouts, spending the outputs of
+// the previous block, and 50 pegins. The verification caches are cleared
+// before every run, as for a block none of whose transactions were in the mempool.
+static void MWEBValidateBlock(benchmark::Bench& bench)
+{
+    const BasicTestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    test::Miner miner(GetDataDir());
+
+    std::vector<test::Tx> prev_txs;
+    for (size_t i = 0; i < 50; i++) {
+        prev_txs.push_back(test::Tx::CreatePegIn(1'000'000 + i));
+    }
+    miner.MineBlock(1, prev_txs);
+
+    std::vector<test::Tx> txs;
+    std::vector<PegInCoin> pegins;
+    std::vector<PegOutCoin> pegouts;
+    for (size_t i = 0; i < 50; i++) {
+        txs.push_back(test::Tx::CreatePegOut(prev_txs[i].GetOutputs().front(), 1000));
+        pegouts.push_back(txs.back().GetPegOutCoin());
+
+        txs.push_back(test::Tx::CreatePegIn(2'000'000 + i));
+        pegins.push_back(txs.back().GetPegInCoin());
+    }
+
+    const mw::Block::CPtr pBlock = miner.MineBlock(2, txs).GetBlock();
+
+    bench.unit("block").run([&] {
+        Bulletproofs::SetCacheSize(0);
+        Schnorr::SetCacheSize(0);
+        TxBody::SetCacheSize(0);
+
+        bool valid = BlockValidator::ValidateBlock(pBlock, pegins, pegouts);
+        assert(valid);
+    });
+
+    Bulletproofs::SetCacheSize(VerificationCache::DEFAULT_SIZE);
+    Schnorr::SetCacheSize(VerificationCache::DEFAULT_SIZE);
+    TxBody::SetCacheSize(VerificationCache::DEFAULT_SIZE);
+}
+
+BENCHMARK(MWEBValidateBlock);
@@ -0,0 +1,107 @@
+// Copyright (c) 2021 The Junkcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <mw/consensus/Aggregation.h>
+#include <mw/consensus/KernelSumValidator.h>
+#include <mw/crypto/Bulletproofs.h>
+#include <mw/crypto/Hasher.h>
+#include <mw/crypto/Pedersen.h>
+#include <mw/crypto/Schnorr.h>
+#include <mw/crypto/VerificationCache.h>
+
+#include <test_framework/models/Tx.h>
+
+// The verification caches are cleared before every run, so these measure
+// verifying proofs and signatures that haven't been seen before.
+
+static std::vector<ProofData> CreateProofs(const size_t num_proofs)
+{
+    std::vector<ProofData> proofs;
+    for (size_t i = 0; i < num_proofs; i++) {
+        BlindingFactor blind = BlindingFactor::Random();
+        std::vector<uint8_t> extra_data = SecretKey::Random().vec();
+        RangeProof::CPtr pRangeProof = Bulletproofs::Generate(
+            i,
+            SecretKey(blind.vec()),
+            SecretKey::Random(),
+            SecretKey::Random(),
+            ProofMessage(secret_key_t<20>::Random().GetBigInt()),
+            extra_data
+        );
+        proofs.push_back(ProofData{ Commitment::Blinded(blind, i), pRangeProof, extra_data });
+    }
+
+    return proofs;
+}
+
+static void BulletproofsBatchVerify(benchmark::Bench& bench, const size_t num_proofs)
+{
+    const std::vector<ProofData> proofs = CreateProofs(num_proofs);
+
+    bench.batch(num_proofs).unit("proof").run([&] {
+        Bulletproofs::SetCacheSize(0);
+        bool verified = Bulletproofs::BatchVerify(proofs);
+        assert(verified);
+    });
+
+    Bulletproofs::SetCacheSize(VerificationCache::DEFAULT_SIZE);
+}
+
+static void MWEBBulletproofsBatchVerify1(benchmark::Bench& bench) { BulletproofsBatchVerify(bench, 1); }
+static void MWEBBulletproofsBatchVerify16(benchmark::Bench& bench) { BulletproofsBatchVerify(bench, 16); }
+static void MWEBBulletproofsBatchVerify128(benchmark::Bench& bench) { BulletproofsBatchVerify(bench, 128); }
+
+static void MWEBSchnorrBatchVerify(benchmark::Bench& bench)
+{
+    std::vector<SignedMessage> signatures;
+    for (size_t i = 0; i < 100; i++) {
+        signatures.push_back(Schnorr::SignMessage(SecretKey::Random(), Hashed(SecretKey::Random().vec())));
+    }
+
+    bench.batch(signatures.size()).unit("signature").run([&] {
+        Schnorr::SetCacheSize(0);
+        bool verified = Schnorr::BatchVerify(signatures);
+        assert(verified);
+    });
+
+    Schnorr::SetCacheSize(VerificationCache::DEFAULT_SIZE);
+}
+
+static void MWEBPedersenAddCommitments(benchmark::Bench& bench)
+{
+    std::vector<Commitment> positive;
+    std::vector<Commitment> negative;
+    for (uint64_t i = 0; i < 500; i++) {
+        positive.push_back(Commitment::Blinded(BlindingFactor::Random(), i));
+        negative.push_back(Commitment::Blinded(BlindingFactor::Random(), i));
+    }
+
+    bench.batch(positive.size() + negative.size()).unit("commitment").run([&] {
+        Commitment sum = Pedersen::AddCommitments(positive, negative);
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+}
+
+static void MWEBKernelSumValidator(benchmark::Bench& bench)
+{
+    std::vector<mw::Transaction::CPtr> transactions;
+    for (size_t i = 0; i < 100; i++) {
+        transactions.push_back(test::Tx::CreatePegIn(1'000'000 + i).GetTransaction());
+    }
+
+    mw::Transaction::CPtr pTransaction = Aggregation::Aggregate(transactions);
+
+    bench.batch(pTransaction->GetKernels().size()).unit("kernel").run([&] {
+        KernelSumValidator::ValidateForTx(*pTransaction);
+    });
+}
+
+BENCHMARK(MWEBBulletproofsBatchVerify1);
+BENCHMARK(MWEBBulletproofsBatchVerify16);
+BENCHMARK(MWEBBulletproofsBatchVerify128);
+BENCHMARK(MWEBSchnorrBatchVerify);
+BENCHMARK(MWEBPedersenAddCommitments);
+BENCHMARK(MWEBKernelSumValidator);
@@ -0,0 +1,118 @@
+// Copyright (c) 2021 The Junkcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <dbwrapper.h>
+#include <mweb/mweb_db.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+
+#include <mw/mmr/LeafSet.h>
+#include <mw/mmr/MMR.h>
+#include <mw/models/crypto/SecretKey.h>
+
+// Number of leaves already in the MMR, and the number each run appends (about a block's worth).
+static const uint64_t NUM_EXISTING_LEAVES = 10'000;
+static const uint64_t NUM_BLOCK_LEAVES = 1'000;
+
+static std::vector<mmr::Leaf> CreateLeaves(const uint64_t first_leaf, const uint64_t num_leaves)
+{
+    std::vector<mmr::Leaf> leaves;
+    for (uint64_t i = first_leaf; i < first_leaf + num_leaves; i++) {
+        leaves.push_back(mmr::Leaf::Create(mmr::LeafIndex::At(i), SecretKey::Random().vec()));
+    }
+
+    return leaves;
+}
+
+static PMMR::Ptr OpenPMMR(const mw::DBWrapper::Ptr& pDB)
+{
+    PMMR::Ptr pmmr = PMMR::Open('O', GetDataDir() / "mmr", 0, pDB, nullptr);
+
+    PMMRCache cache(pmmr);
+    cache.AddLeaves(CreateLeaves(0, NUM_EXISTING_LEAVES));
+    cache.Flush(1, nullptr);
+
+    return pmmr;
+}
+
+static void MWEBPMMRAppend(benchmark::Bench& bench)
+{
+    const BasicTestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    CDBWrapper db(GetDataDir() / "db", 1 << 20, true);
+    PMMR::Ptr pmmr = OpenPMMR(std::make_shared<MWEB::DBWrapper>(&db));
+
+    const std::vector<mmr::Leaf> leaves = CreateLeaves(NUM_EXISTING_LEAVES, NUM_BLOCK_LEAVES);
+
+    bench.batch(leaves.size()).unit("leaf").run([&] {
+        PMMRCache cache(pmmr);
+        cache.AddLeaves(leaves);
+    });
+}
+
+static void MWEBPMMRRoot(benchmark::Bench& bench)
+{
+    const BasicTestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    CDBWrapper db(GetDataDir() / "db", 1 << 20, true);
+    PMMR::Ptr pmmr = OpenPMMR(std::make_shared<MWEB::DBWrapper>(&db));
+
+    PMMRCache cache(pmmr);
+    cache.AddLeaves(CreateLeaves(NUM_EXISTING_LEAVES, NUM_BLOCK_LEAVES));
+
+    bench.run([&] {
+        mw::Hash root = cache.Root();
+        ankerl::nanobench::doNotOptimizeAway(root);
+    });
+}
+
+// Rewinds a block's worth of leaves and appends them again, as in a one block reorg.
+static void MWEBPMMRRewind(benchmark::Bench& bench)
+{
+    const BasicTestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    CDBWrapper db(GetDataDir() / "db", 1 << 20, true);
+    PMMR::Ptr pmmr = OpenPMMR(std::make_shared<MWEB::DBWrapper>(&db));
+
+    const std::vector<mmr::Leaf> leaves = CreateLeaves(NUM_EXISTING_LEAVES, NUM_BLOCK_LEAVES);
+    PMMRCache cache(pmmr);
+    cache.AddLeaves(leaves);
+
+    bench.batch(leaves.size()).unit("leaf").run([&] {
+        cache.Rewind(NUM_EXISTING_LEAVES);
+        cache.AddLeaves(leaves);
+    });
+}
+
+// Spends or unspends a block's worth of leaves, then writes the leafset to a new file.
+static void MWEBLeafSetFlush(benchmark::Bench& bench)
+{
+    const BasicTestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    LeafSet::Ptr pLeafSet = LeafSet::Open(GetDataDir(), 0);
+    for (uint64_t i = 0; i < NUM_EXISTING_LEAVES * 10; i++) {
+        pLeafSet->Add(mmr::LeafIndex::At(i));
+    }
+
+    uint32_t file_index = 1;
+    pLeafSet->Flush(file_index);
+
+    FastRandomContext rng(true);
+    bench.batch(NUM_BLOCK_LEAVES).unit("leaf").run([&] {
+        LeafSetCache::Ptr pCache = std::make_shared<LeafSetCache>(pLeafSet);
+        for (uint64_t i = 0; i < NUM_BLOCK_LEAVES; i++) {
+            const mmr::LeafIndex idx = mmr::LeafIndex::At(rng.randrange(NUM_EXISTING_LEAVES * 10));
+            if (pCache->Contains(idx)) {
+                pCache->Remove(idx);
+            } else {
+                pCache->Add(idx);
+            }
+        }
+
+        pCache->Flush(++file_index);
+        pLeafSet->Cleanup(file_index);
+    });
+}
+
+BENCHMARK(MWEBPMMRAppend);
+BENCHMARK(MWEBPMMRRoot);
+BENCHMARK(MWEBPMMRRewind);
+BENCHMARK(MWEBLeafSetFlush);
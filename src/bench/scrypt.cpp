@@ -0,0 +1,176 @@
+// Copyright (c) 2024 The Junkcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/data.h>
+
+#include <arith_uint256.h>
+#include <auxpow.h>
+#include <chainparams.h>
+#include <crypto/scrypt.h>
+#include <junkcoin.h>
+#include <pow.h>
+#include <script/script.h>
+#include <streams.h>
+#include <test/util/mining.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <util/strencodings.h>
+#include <validation.h>
+
+#include <vector>
+
+/** 80-byte header of the benchmark block, as hashed by GetPoWHash() */
+static std::vector<char> BenchHeaderBytes()
+{
+    CDataStream stream(benchmark::data::block413567, SER_NETWORK, PROTOCOL_VERSION);
+    CBlock block;
+    stream >> block;
+    CPureBlockHeader pure;
+    pure.nVersion = block.nVersion;
+    pure.hashPrevBlock = block.hashPrevBlock;
+    pure.hashMerkleRoot = block.hashMerkleRoot;
+    pure.nTime = block.nTime;
+    pure.nBits = block.nBits;
+    pure.nNonce = block.nNonce;
+    return std::vector<char>(BEGIN(pure.nVersion), BEGIN(pure.nVersion) + 80);
+}
+
+/** A header on regtest difficulty whose proof of work is valid */
+static CBlockHeader MineBenchHeader(const Consensus::Params& params, bool auxpow)
+{
+    CBlockHeader header;
+    header.SetBaseVersion(4, params.nAuxpowChainId);
+    header.hashPrevBlock = uint256S("0babe680f55a55d54339511226755f0837261da89a4e78eba4d6436a63026df8");
+    header.nTime = 1700000000;
+    header.nBits = UintToArith256(params.powLimit).GetCompact();
+    if (auxpow) {
+        CAuxPow::initAuxPow(header);
+        while (!CheckProofOfWork(header.auxpow->getParentBlockPoWHash(), header.nBits, params)) {
+            ++header.auxpow->parentBlock.nNonce;
+        }
+    } else {
+        while (!CheckProofOfWork(header.GetPoWHash(), header.nBits, params)) {
+            ++header.nNonce;
+        }
+    }
+    return header;
+}
+
+static void ScryptGeneric(benchmark::Bench& bench)
+{
+    const std::vector<char> input = BenchHeaderBytes();
+    char scratchpad[SCRYPT_SCRATCHPAD_SIZE];
+    uint256 hash;
+    bench.unit("hash").run([&] {
+        scrypt_1024_1_1_256_sp_generic(input.data(), BEGIN(hash), scratchpad);
+    });
+}
+
+#if defined(USE_SSE2)
+static void ScryptSSE2(benchmark::Bench& bench)
+{
+    const std::vector<char> input = BenchHeaderBytes();
+    char scratchpad[SCRYPT_SCRATCHPAD_SIZE];
+    uint256 hash;
+    bench.unit("hash").run([&] {
+        scrypt_1024_1_1_256_sp_sse2(input.data(), BEGIN(hash), scratchpad);
+    });
+}
+#endif
+
+static void ScryptMulti(benchmark::Bench& bench)
+{
+    (void) scrypt_detect_multi();
+    const size_t lanes = scrypt_multi_lanes();
+    const std::vector<char> header = BenchHeaderBytes();
+    std::vector<char> inputs(lanes * 80);
+    std::vector<char> outputs(lanes * 32);
+    for (size_t i = 0; i < lanes; i++) {
+        memcpy(&inputs[i * 80], header.data(), 80);
+        inputs[i * 80 + 76] = (char)i;
+    }
+    bench.batch(lanes).unit("hash").run([&] {
+        scrypt_1024_1_1_256_multi(inputs.data(), outputs.data(), lanes);
+    });
+}
+
+static void BlockHeaderGetPoWHash(benchmark::Bench& bench)
+{
+    CDataStream stream(benchmark::data::block413567, SER_NETWORK, PROTOCOL_VERSION);
+    CBlock block;
+    stream >> block;
+    const CBlockHeader header = block.GetBlockHeader();
+    bench.unit("header").run([&] {
+        ankerl::nanobench::doNotOptimizeAway(header.GetPoWHash());
+    });
+}
+
+static void CheckAuxPowProofOfWorkLegacy(benchmark::Bench& bench)
+{
+    ArgsManager bench_args;
+    const auto chainParams = CreateChainParams(bench_args, CBaseChainParams::REGTEST);
+    const Consensus::Params& params = chainParams->GetConsensus();
+    const CBlockHeader header = MineBenchHeader(params, false);
+    bench.unit("header").run([&] {
+        bool checked = CheckAuxPowProofOfWork(header, params);
+        assert(checked);
+    });
+}
+
+static void CheckAuxPowProofOfWorkAuxpow(benchmark::Bench& bench)
+{
+    ArgsManager bench_args;
+    const auto chainParams = CreateChainParams(bench_args, CBaseChainParams::REGTEST);
+    const Consensus::Params& params = chainParams->GetConsensus();
+    const CBlockHeader header = MineBenchHeader(params, true);
+    bench.unit("header").run([&] {
+        bool checked = CheckAuxPowProofOfWork(header, params);
+        assert(checked);
+    });
+}
+
+// Reading a block back goes through CheckAuxPowProofOfWork. By position the
+// scrypt hash is recomputed; by index the hash cached in the block index is used.
+static void ReadBlockFromDiskTest(benchmark::Bench& bench, bool by_index)
+{
+    TestingSetup test_setup{
+        CBaseChainParams::REGTEST,
+        /* extra_args */ {
+            "-nodebuglogfile",
+            "-nodebug",
+        },
+    };
+    MineBlock(test_setup.m_node, CScript() << OP_TRUE);
+
+    const Consensus::Params& params = Params().GetConsensus();
+    const CBlockIndex* pindex = WITH_LOCK(::cs_main, return ::ChainActive().Tip());
+    const FlatFilePos pos = WITH_LOCK(::cs_main, return pindex->GetBlockPos());
+    bench.unit("block").run([&] {
+        CBlock block;
+        bool read = by_index ? ReadBlockFromDisk(block, pindex, params) : ReadBlockFromDisk(block, pos, params);
+        assert(read);
+    });
+}
+
+static void ReadBlockFromDiskByPos(benchmark::Bench& bench)
+{
+    ReadBlockFromDiskTest(bench, false);
+}
+
+static void ReadBlockFromDiskByIndex(benchmark::Bench& bench)
+{
+    ReadBlockFromDiskTest(bench, true);
+}
+
+BENCHMARK(ScryptGeneric);
+#if defined(USE_SSE2)
+BENCHMARK(ScryptSSE2);
+#endif
+BENCHMARK(ScryptMulti);
+BENCHMARK(BlockHeaderGetPoWHash);
+BENCHMARK(CheckAuxPowProofOfWorkLegacy);
+BENCHMARK(CheckAuxPowProofOfWorkAuxpow);
+BENCHMARK(ReadBlockFromDiskByPos);
+BENCHMARK(ReadBlockFromDiskByIndex);
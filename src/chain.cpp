@@ -4,6 +4,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <chain.h>
+#include <auxpowcache.h>
 #include <chainparams.h>
 #include <validation.h>
 
@@ -19,11 +20,15 @@ CBlockHeader CBlockIndex::GetBlockHeader() const
     block.nNonce         = nNonce;
 
     /* The CBlockIndex object's block header is missing the auxpow.
-       So if this is an auxpow block, read it from disk instead.  We only
-       have to read the actual *header*, not the full block.  */
+       So if this is an auxpow block, take it from the auxpow cache or
+       read it from disk instead.  We only have to read the actual
+       *header*, not the full block.  */
     if (block.IsAuxpow())
     {
-        ReadBlockHeaderFromDisk(block, this, Params().GetConsensus());
+        block.auxpow = g_auxpow_cache.Get(GetBlockHash());
+        if (!block.auxpow && ReadBlockHeaderFromDisk(block, this, Params().GetConsensus())) {
+            g_auxpow_cache.Insert(GetBlockHash(), block.auxpow);
+        }
     }
 
     return block;
@@ -128,6 +128,8 @@ enum BlockStatus: uint32_t {
 
     BLOCK_OPT_WITNESS       =   128, //!< block data in blk*.data was received with a witness-enforcing client
 
+    BLOCK_HAVE_POW_HASH     =   (1 << 27), //!< hashPoW holds the verified proof-of-work hash of the header
+
     BLOCK_HAVE_MWEB         =   (1 << 28)
 };
 
@@ -187,6 +189,10 @@ public:
     uint256 hogex_hash{};
     CAmount mweb_amount{0};
 
+    //! Scrypt hash carrying this header's proof-of-work, i.e. the parent block's for auxpow headers
+    //! (only populated when BLOCK_HAVE_POW_HASH is set)
+    uint256 hashPoW{};
+
     //! (memory only) Sequential id assigned to distinguish order in which blocks are received.
     int32_t nSequenceId{0};
 
@@ -356,6 +362,9 @@ public:
         READWRITE(obj.nTime);
         READWRITE(obj.nBits);
         READWRITE(obj.nNonce);
+
+        // Appended after the header so that older versions ignore it
+        if (obj.nStatus & BLOCK_HAVE_POW_HASH) READWRITE(obj.hashPoW);
     }
 
     uint256 GetBlockHash() const
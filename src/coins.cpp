@@ -10,6 +10,15 @@
 #include <version.h>
 
 bool CCoinsView::GetCoin(const COutPoint &outpoint, Coin &coin) const { return false; }
+void CCoinsView::GetCoins(const std::vector<COutPoint>& outpoints, std::vector<Coin>& coins) const
+{
+    coins.assign(outpoints.size(), Coin());
+    for (size_t i = 0; i < outpoints.size(); i++) {
+        if (!GetCoin(outpoints[i], coins[i])) {
+            coins[i].Clear();
+        }
+    }
+}
 uint256 CCoinsView::GetBestBlock() const { return uint256(); }
 std::vector<uint256> CCoinsView::GetHeadBlocks() const { return std::vector<uint256>(); }
 bool CCoinsView::BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock, const mw::CoinsViewCache::Ptr& derivedView) { return false; }
@@ -28,6 +37,7 @@ bool CCoinsView::HaveCoin(const OutputIndex& index) const
 
 CCoinsViewBacked::CCoinsViewBacked(CCoinsView *viewIn) : base(viewIn) { }
 bool CCoinsViewBacked::GetCoin(const COutPoint &outpoint, Coin &coin) const { return base->GetCoin(outpoint, coin); }
+void CCoinsViewBacked::GetCoins(const std::vector<COutPoint>& outpoints, std::vector<Coin>& coins) const { base->GetCoins(outpoints, coins); }
 bool CCoinsViewBacked::HaveCoin(const OutputIndex& index) const { return base->HaveCoin(index); }
 uint256 CCoinsViewBacked::GetBestBlock() const { return base->GetBestBlock(); }
 std::vector<uint256> CCoinsViewBacked::GetHeadBlocks() const { return base->GetHeadBlocks(); }
@@ -72,6 +82,41 @@ bool CCoinsViewCache::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     return false;
 }
 
+void CCoinsViewCache::GetCoins(const std::vector<COutPoint>& outpoints, std::vector<Coin>& coins) const {
+    PrefetchCoins(outpoints);
+
+    coins.assign(outpoints.size(), Coin());
+    for (size_t i = 0; i < outpoints.size(); i++) {
+        CCoinsMap::const_iterator it = cacheCoins.find(outpoints[i]);
+        if (it != cacheCoins.end()) {
+            coins[i] = it->second.coin;
+        }
+    }
+}
+
+void CCoinsViewCache::PrefetchCoins(const std::vector<COutPoint>& outpoints) const {
+    std::vector<COutPoint> missing;
+    for (const COutPoint& outpoint : outpoints) {
+        if (cacheCoins.count(outpoint) == 0) {
+            missing.push_back(outpoint);
+        }
+    }
+    if (missing.empty()) return;
+
+    std::vector<Coin> coins;
+    base->GetCoins(missing, coins);
+    for (size_t i = 0; i < missing.size(); i++) {
+        // Like FetchCoin, only coins the backing view has are cached.
+        if (coins[i].IsSpent()) continue;
+        CCoinsMap::iterator it;
+        bool inserted;
+        std::tie(it, inserted) = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(missing[i]), std::forward_as_tuple(std::move(coins[i])));
+        if (inserted) {
+            cachedCoinsUsage += it->second.coin.DynamicMemoryUsage();
+        }
+    }
+}
+
 void CCoinsViewCache::AddCoin(const COutPoint &outpoint, Coin&& coin, bool possible_overwrite) {
     assert(!coin.IsSpent());
     if (coin.out.scriptPubKey.IsUnspendable()) return;
@@ -336,3 +381,16 @@ bool CCoinsViewErrorCatcher::GetCoin(const COutPoint &outpoint, Coin &coin) cons
         std::abort();
     }
 }
+
+void CCoinsViewErrorCatcher::GetCoins(const std::vector<COutPoint>& outpoints, std::vector<Coin>& coins) const {
+    try {
+        CCoinsViewBacked::GetCoins(outpoints, coins);
+    } catch(const std::runtime_error& e) {
+        for (auto f : m_err_callbacks) {
+            f();
+        }
+        LogPrintf("Error reading from database: %s\n", e.what());
+        // See GetCoin above.
+        std::abort();
+    }
+}
@@ -196,6 +196,12 @@ public:
      */
     virtual bool GetCoin(const COutPoint &outpoint, Coin &coin) const;
 
+    /** Retrieve the Coins for several outpoints at once.
+     *  On return, coins holds one Coin per outpoint, which is spent (empty)
+     *  when no unspent coin was found for it.
+     */
+    virtual void GetCoins(const std::vector<COutPoint>& outpoints, std::vector<Coin>& coins) const;
+
     //! Just check whether a given outpoint is unspent.
     virtual bool HaveCoin(const OutputIndex& index) const;
 
@@ -236,6 +242,7 @@ protected:
 public:
     CCoinsViewBacked(CCoinsView *viewIn);
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    void GetCoins(const std::vector<COutPoint>& outpoints, std::vector<Coin>& coins) const override;
     bool HaveCoin(const OutputIndex& index) const override;
     uint256 GetBestBlock() const override;
     std::vector<uint256> GetHeadBlocks() const override;
@@ -274,6 +281,7 @@ public:
 
     // Standard CCoinsView methods
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    void GetCoins(const std::vector<COutPoint>& outpoints, std::vector<Coin>& coins) const override;
     bool HaveCoin(const OutputIndex& outpoint) const override;
     uint256 GetBestBlock() const override;
     void SetBestBlock(const uint256& hashBlock);
@@ -295,6 +303,14 @@ public:
      */
     bool HaveCoinInCache(const OutputIndex& outpoint) const;
 
+    /**
+     * Load the unspent coins for the given outpoints that aren't cached yet,
+     * fetching them from the backing view with a single GetCoins call.
+     * This warms the cache ahead of many lookups, like the inputs of a block
+     * that's about to be connected.
+     */
+    void PrefetchCoins(const std::vector<COutPoint>& outpoints) const;
+
     /**
      * Return a reference to Coin in the cache, or coinEmpty if not found. This is
      * more efficient than GetCoin.
@@ -388,6 +404,7 @@ public:
     }
 
     bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    void GetCoins(const std::vector<COutPoint>& outpoints, std::vector<Coin>& coins) const override;
 
 private:
     /** A list of callbacks to execute upon leveldb read error. */
@@ -34,7 +34,6 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
-#include <openssl/sha.h>
 
 #include <emmintrin.h>
 
@@ -102,12 +101,14 @@ void scrypt_1024_1_1_256_sp_sse2(const char *input, char *output, char *scratchp
 		__m128i i128[8];
 		uint32_t u32[32];
 	} X;
+	HMAC_SHA256_CTX hctx;
 	__m128i *V;
 	uint32_t i, j, k;
 
 	V = (__m128i *)(((uintptr_t)(scratchpad) + 63) & ~ (uintptr_t)(63));
 
-	PBKDF2_SHA256((const uint8_t *)input, 80, (const uint8_t *)input, 80, 1, B, 128);
+	scrypt_hmac_init(&hctx, input);
+	scrypt_pbkdf2_in(&hctx, input, B);
 
 	for (k = 0; k < 2; k++) {
 		for (i = 0; i < 16; i++) {
@@ -135,7 +136,7 @@ void scrypt_1024_1_1_256_sp_sse2(const char *input, char *output, char *scratchp
 		}
 	}
 
-	PBKDF2_SHA256((const uint8_t *)input, 80, B, 128, 1, (uint8_t *)output, 32);
+	scrypt_pbkdf2_out(&hctx, B, output);
 }
 
 #endif // USE_SSE2
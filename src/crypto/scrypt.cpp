@@ -28,11 +28,15 @@
  */
 
 #include <crypto/scrypt.h>
+#include <crypto/common.h>
 
+#include <assert.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
-#include <openssl/sha.h>
+#include <memory>
+
+#include <compat/cpuid.h>
 
 #if defined(USE_SSE2) && !defined(USE_SSE2_ALWAYS)
 #ifdef _MSC_VER
@@ -61,11 +65,6 @@ static inline void be32enc(void *pp, uint32_t x)
 }
 
 #endif
-typedef struct HMAC_SHA256Context {
-	SHA256_CTX ictx;
-	SHA256_CTX octx;
-} HMAC_SHA256_CTX;
-
 /* Initialize an HMAC-SHA256 operation with the given key. */
 static void
 HMAC_SHA256_Init(HMAC_SHA256_CTX *ctx, const void *_K, size_t Klen)
@@ -77,26 +76,24 @@ HMAC_SHA256_Init(HMAC_SHA256_CTX *ctx, const void *_K, size_t Klen)
 
 	/* If Klen > 64, the key is really SHA256(K). */
 	if (Klen > 64) {
-		SHA256_Init(&ctx->ictx);
-		SHA256_Update(&ctx->ictx, K, Klen);
-		SHA256_Final(khash, &ctx->ictx);
+		CSHA256().Write(K, Klen).Finalize(khash);
 		K = khash;
 		Klen = 32;
 	}
 
 	/* Inner SHA256 operation is SHA256(K xor [block of 0x36] || data). */
-	SHA256_Init(&ctx->ictx);
+	ctx->ictx.Reset();
 	memset(pad, 0x36, 64);
 	for (i = 0; i < Klen; i++)
 		pad[i] ^= K[i];
-	SHA256_Update(&ctx->ictx, pad, 64);
+	ctx->ictx.Write(pad, 64);
 
 	/* Outer SHA256 operation is SHA256(K xor [block of 0x5c] || hash). */
-	SHA256_Init(&ctx->octx);
+	ctx->octx.Reset();
 	memset(pad, 0x5c, 64);
 	for (i = 0; i < Klen; i++)
 		pad[i] ^= K[i];
-	SHA256_Update(&ctx->octx, pad, 64);
+	ctx->octx.Write(pad, 64);
 
 	/* Clean the stack. */
 	memset(khash, 0, 32);
@@ -107,7 +104,7 @@ static void
 HMAC_SHA256_Update(HMAC_SHA256_CTX *ctx, const void *in, size_t len)
 {
 	/* Feed data to the inner SHA256 operation. */
-	SHA256_Update(&ctx->ictx, in, len);
+	ctx->ictx.Write((const unsigned char *)in, len);
 }
 
 /* Finish an HMAC-SHA256 operation. */
@@ -117,13 +114,10 @@ HMAC_SHA256_Final(unsigned char digest[32], HMAC_SHA256_CTX *ctx)
 	unsigned char ihash[32];
 
 	/* Finish the inner SHA256 operation. */
-	SHA256_Final(ihash, &ctx->ictx);
-
-	/* Feed the inner hash to the outer SHA256 operation. */
-	SHA256_Update(&ctx->octx, ihash, 32);
+	ctx->ictx.Finalize(ihash);
 
-	/* Finish the outer SHA256 operation. */
-	SHA256_Final(digest, &ctx->octx);
+	/* Feed the inner hash to the outer SHA256 operation and finish it. */
+	ctx->octx.Write(ihash, 32).Finalize(digest);
 
 	/* Clean the stack. */
 	memset(ihash, 0, 32);
@@ -157,7 +151,7 @@ PBKDF2_SHA256(const uint8_t *passwd, size_t passwdlen, const uint8_t *salt,
 		be32enc(ivec, (uint32_t)(i + 1));
 
 		/* Compute U_1 = PRF(P, S || INT(i)). */
-		memcpy(&hctx, &PShctx, sizeof(HMAC_SHA256_CTX));
+		hctx = PShctx;
 		HMAC_SHA256_Update(&hctx, ivec, 4);
 		HMAC_SHA256_Final(U, &hctx);
 
@@ -181,9 +175,36 @@ PBKDF2_SHA256(const uint8_t *passwd, size_t passwdlen, const uint8_t *salt,
 			clen = 32;
 		memcpy(&buf[i * 32], T, clen);
 	}
+}
 
-	/* Clean PShctx, since we never called _Final on it. */
-	memset(&PShctx, 0, sizeof(HMAC_SHA256_CTX));
+void scrypt_hmac_init(HMAC_SHA256_CTX *hctx, const char *input)
+{
+	HMAC_SHA256_Init(hctx, input, 80);
+}
+
+void scrypt_pbkdf2_in(const HMAC_SHA256_CTX *hctx, const char *input, uint8_t B[128])
+{
+	HMAC_SHA256_CTX PShctx = *hctx, ctx;
+	uint8_t ivec[4];
+
+	/* The salt is the header itself; absorb it once for all four blocks. */
+	HMAC_SHA256_Update(&PShctx, input, 80);
+	for (uint32_t i = 0; i < 4; i++) {
+		be32enc(ivec, i + 1);
+		ctx = PShctx;
+		HMAC_SHA256_Update(&ctx, ivec, 4);
+		HMAC_SHA256_Final(&B[i * 32], &ctx);
+	}
+}
+
+void scrypt_pbkdf2_out(const HMAC_SHA256_CTX *hctx, const uint8_t B[128], char *output)
+{
+	static const uint8_t ivec[4] = {0, 0, 0, 1};
+	HMAC_SHA256_CTX ctx = *hctx;
+
+	HMAC_SHA256_Update(&ctx, B, 128);
+	HMAC_SHA256_Update(&ctx, ivec, 4);
+	HMAC_SHA256_Final((unsigned char *)output, &ctx);
 }
 
 #define ROTL(a, b) (((a) << (b)) | ((a) >> (32 - (b))))
@@ -259,12 +280,14 @@ void scrypt_1024_1_1_256_sp_generic(const char *input, char *output, char *scrat
 {
 	uint8_t B[128];
 	uint32_t X[32];
+	HMAC_SHA256_CTX hctx;
 	uint32_t *V;
 	uint32_t i, j, k;
 
 	V = (uint32_t *)(((uintptr_t)(scratchpad) + 63) & ~ (uintptr_t)(63));
 
-	PBKDF2_SHA256((const uint8_t *)input, 80, (const uint8_t *)input, 80, 1, B, 128);
+	scrypt_hmac_init(&hctx, input);
+	scrypt_pbkdf2_in(&hctx, input, B);
 
 	for (k = 0; k < 32; k++)
 		X[k] = le32dec(&B[4 * k]);
@@ -285,7 +308,7 @@ void scrypt_1024_1_1_256_sp_generic(const char *input, char *output, char *scrat
 	for (k = 0; k < 32; k++)
 		le32enc(&B[4 * k], X[k]);
 
-	PBKDF2_SHA256((const uint8_t *)input, 80, B, 128, 1, (uint8_t *)output, 32);
+	scrypt_pbkdf2_out(&hctx, B, output);
 }
 
 #if defined(USE_SSE2)
@@ -331,3 +354,170 @@ void scrypt_1024_1_1_256(const char *input, char *output)
 	char scratchpad[SCRYPT_SCRATCHPAD_SIZE];
     scrypt_1024_1_1_256_sp(input, output, scratchpad);
 }
+
+#if defined(__SSE2__)
+namespace scrypt_sse2
+{
+void Core_4way(uint32_t* X, uint32_t* V);
+}
+#endif
+
+namespace scrypt_avx2
+{
+void Core_8way(uint32_t* X, uint32_t* V);
+}
+
+namespace scrypt_avx512
+{
+void Core_16way(uint32_t* X, uint32_t* V);
+}
+
+namespace
+{
+typedef void (*ScryptCoreMulti)(uint32_t* X, uint32_t* V);
+
+/** Multi-lane ROMix kernels, widest last. A null entry is unavailable. */
+#if defined(__SSE2__)
+ScryptCoreMulti scrypt_core_4way = scrypt_sse2::Core_4way;
+#else
+ScryptCoreMulti scrypt_core_4way = nullptr;
+#endif
+ScryptCoreMulti scrypt_core_8way = nullptr;
+ScryptCoreMulti scrypt_core_16way = nullptr;
+
+const size_t MAX_LANES = 16;
+
+/** Hash `lanes` headers through one multi-lane kernel. V must be 64-byte
+ *  aligned and hold lanes * 128 KiB. */
+void scrypt_1024_1_1_256_lanes(const char *inputs, char *outputs, size_t lanes, ScryptCoreMulti core, uint32_t *V)
+{
+    uint8_t B[128];
+    uint32_t X[MAX_LANES * 32];
+    HMAC_SHA256_CTX hctx[MAX_LANES];
+
+    for (size_t l = 0; l < lanes; l++) {
+        const char *input = inputs + l * 80;
+        scrypt_hmac_init(&hctx[l], input);
+        scrypt_pbkdf2_in(&hctx[l], input, B);
+        for (int k = 0; k < 32; k++)
+            X[l * 32 + k] = le32dec(&B[4 * k]);
+    }
+
+    core(X, V);
+
+    for (size_t l = 0; l < lanes; l++) {
+        for (int k = 0; k < 32; k++)
+            le32enc(&B[4 * k], X[l * 32 + k]);
+        scrypt_pbkdf2_out(&hctx[l], B, outputs + l * 32);
+    }
+}
+
+/** Check every selected kernel against the single-lane implementation. */
+bool scrypt_multi_selftest()
+{
+    char inputs[MAX_LANES * 80];
+    char expected[MAX_LANES * 32];
+    char outputs[MAX_LANES * 32];
+    char scratchpad[SCRYPT_SCRATCHPAD_SIZE];
+
+    for (size_t i = 0; i < sizeof(inputs); i++)
+        inputs[i] = (char)(i * 7 + 1);
+    for (size_t l = 0; l < MAX_LANES; l++)
+        scrypt_1024_1_1_256_sp_generic(inputs + l * 80, expected + l * 32, scratchpad);
+
+    const struct { size_t lanes; ScryptCoreMulti core; } kernels[] = {
+        {4, scrypt_core_4way}, {8, scrypt_core_8way}, {16, scrypt_core_16way},
+    };
+    for (const auto& kernel : kernels) {
+        if (!kernel.core) continue;
+        std::unique_ptr<char[]> pad(new char[kernel.lanes * 131072 + 63]);
+        uint32_t *V = (uint32_t *)(((uintptr_t)(pad.get()) + 63) & ~ (uintptr_t)(63));
+        scrypt_1024_1_1_256_lanes(inputs, outputs, kernel.lanes, kernel.core, V);
+        if (memcmp(outputs, expected, kernel.lanes * 32) != 0) return false;
+    }
+    return true;
+}
+
+#if defined(HAVE_GETCPUID)
+/** Return the XCR0 register, i.e. which register states the OS saves. */
+uint32_t GetXCR0()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return a;
+}
+#endif
+} // namespace
+
+std::string scrypt_detect_multi()
+{
+    std::string ret;
+#if defined(__SSE2__)
+    ret = "sse2(4way)";
+#endif
+#if defined(HAVE_GETCPUID)
+    bool have_avx2 = false;
+    bool have_avx512 = false;
+    uint32_t xcr0 = 0;
+
+    (void)have_avx2;
+    (void)have_avx512;
+
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    // XSAVE and AVX must both be present before xgetbv may be executed.
+    if (((ecx >> 27) & 1) && ((ecx >> 28) & 1)) {
+        xcr0 = GetXCR0();
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+        have_avx2 = ((ebx >> 5) & 1) && (xcr0 & 0x06) == 0x06;
+        have_avx512 = ((ebx >> 16) & 1) && (xcr0 & 0xe6) == 0xe6;
+    }
+
+#if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
+    if (have_avx2) {
+        scrypt_core_8way = scrypt_avx2::Core_8way;
+        ret += std::string(ret.empty() ? "" : ",") + "avx2(8way)";
+    }
+#endif
+#if defined(ENABLE_AVX512) && !defined(BUILD_BITCOIN_INTERNAL)
+    if (have_avx512) {
+        scrypt_core_16way = scrypt_avx512::Core_16way;
+        ret += std::string(ret.empty() ? "" : ",") + "avx512(16way)";
+    }
+#endif
+#endif
+
+    assert(scrypt_multi_selftest());
+    return "scrypt: multi-lane kernels " + (ret.empty() ? std::string("unavailable") : ret);
+}
+
+size_t scrypt_multi_lanes()
+{
+    if (scrypt_core_16way) return 16;
+    if (scrypt_core_8way) return 8;
+    if (scrypt_core_4way) return 4;
+    return 1;
+}
+
+void scrypt_1024_1_1_256_multi(const char *inputs, char *outputs, size_t n)
+{
+    const size_t widest = scrypt_multi_lanes();
+    std::unique_ptr<char[]> scratchpad(new char[(widest > 1 ? widest * 131072 : 131072) + 63]);
+    uint32_t *V = (uint32_t *)(((uintptr_t)(scratchpad.get()) + 63) & ~ (uintptr_t)(63));
+
+    const struct { size_t lanes; ScryptCoreMulti core; } kernels[] = {
+        {16, scrypt_core_16way}, {8, scrypt_core_8way}, {4, scrypt_core_4way},
+    };
+    for (const auto& kernel : kernels) {
+        if (!kernel.core) continue;
+        while (n >= kernel.lanes) {
+            scrypt_1024_1_1_256_lanes(inputs, outputs, kernel.lanes, kernel.core, V);
+            inputs += kernel.lanes * 80;
+            outputs += kernel.lanes * 32;
+            n -= kernel.lanes;
+        }
+    }
+    for (; n > 0; n--, inputs += 80, outputs += 32) {
+        scrypt_1024_1_1_256_sp(inputs, outputs, scratchpad.get());
+    }
+}
@@ -1,8 +1,11 @@
 #ifndef BITCOIN_CRYPTO_SCRYPT_H
 #define BITCOIN_CRYPTO_SCRYPT_H
 
+#include <crypto/sha256.h>
+
 #include <stdlib.h>
 #include <stdint.h>
+#include <string>
 #if defined(__APPLE__)
 #include <sys/endian.h>
 #endif
@@ -13,7 +16,6 @@ void scrypt_1024_1_1_256(const char *input, char *output);
 void scrypt_1024_1_1_256_sp_generic(const char *input, char *output, char *scratchpad);
 
 #if defined(USE_SSE2)
-#include <string>
 #if defined(_M_X64) || defined(__x86_64__) || defined(_M_AMD64) || (defined(MAC_OSX) && defined(__i386__))
 #define USE_SSE2_ALWAYS 1
 #define scrypt_1024_1_1_256_sp(input, output, scratchpad) scrypt_1024_1_1_256_sp_sse2((input), (output), (scratchpad))
@@ -28,6 +30,37 @@ extern void (*scrypt_1024_1_1_256_sp_detected)(const char *input, char *output,
 #define scrypt_1024_1_1_256_sp(input, output, scratchpad) scrypt_1024_1_1_256_sp_generic((input), (output), (scratchpad))
 #endif
 
+/**
+ * Hash n consecutive 80-byte block headers from inputs into n consecutive
+ * 32-byte outputs. Groups of headers are run through the widest multi-lane
+ * ROMix kernel selected by scrypt_detect_multi(); the remainder falls back to
+ * the single-lane path.
+ */
+void scrypt_1024_1_1_256_multi(const char *inputs, char *outputs, size_t n);
+
+/** Select the multi-lane kernels for this CPU and self-test them. Returns a
+ *  description of the kernels in use. */
+std::string scrypt_detect_multi();
+
+/** Number of headers the widest selected multi-lane kernel hashes at once. */
+size_t scrypt_multi_lanes();
+
+/** HMAC-SHA256 state, backed by the autodetected CSHA256 implementation. */
+typedef struct HMAC_SHA256Context {
+    CSHA256 ictx;
+    CSHA256 octx;
+} HMAC_SHA256_CTX;
+
+/**
+ * Both PBKDF2 stages of scrypt_1024_1_1_256 are keyed by the 80-byte header,
+ * so the HMAC pad midstates are computed once by scrypt_hmac_init() and
+ * shared by scrypt_pbkdf2_in() (B = PBKDF2(header, header, 1, 128)) and
+ * scrypt_pbkdf2_out() (output = PBKDF2(header, B, 1, 32)).
+ */
+void scrypt_hmac_init(HMAC_SHA256_CTX *hctx, const char *input);
+void scrypt_pbkdf2_in(const HMAC_SHA256_CTX *hctx, const char *input, uint8_t B[128]);
+void scrypt_pbkdf2_out(const HMAC_SHA256_CTX *hctx, const uint8_t B[128], char *output);
+
 void
 PBKDF2_SHA256(const uint8_t *passwd, size_t passwdlen, const uint8_t *salt,
     size_t saltlen, uint64_t c, uint8_t *buf, size_t dkLen);
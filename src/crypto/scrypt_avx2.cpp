@@ -0,0 +1,111 @@
+// Copyright (c) 2024 The Junkcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Eight-lane scrypt ROMix: each __m256i holds the same Salsa20 word of eight
+// independent hashes, so the mixing rounds need no shuffles at all.
+
+#if defined(ENABLE_AVX2)
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace scrypt_avx2 {
+namespace {
+
+static const int LANES = 8;
+static const int LANE_WORDS = 32 * 1024;
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline RotL(__m256i x, int n) { return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n)); }
+
+/** B = B ^ Bx; B += Salsa20/8(B), on eight lanes at once. */
+void inline XorSalsa8(__m256i* B, const __m256i* Bx)
+{
+    __m256i x[16];
+    for (int i = 0; i < 16; i++) {
+        x[i] = B[i] = Xor(B[i], Bx[i]);
+    }
+    for (int i = 0; i < 8; i += 2) {
+        /* Operate on columns. */
+        x[ 4] = Xor(x[ 4], RotL(Add(x[ 0], x[12]),  7)); x[ 9] = Xor(x[ 9], RotL(Add(x[ 5], x[ 1]),  7));
+        x[14] = Xor(x[14], RotL(Add(x[10], x[ 6]),  7)); x[ 3] = Xor(x[ 3], RotL(Add(x[15], x[11]),  7));
+
+        x[ 8] = Xor(x[ 8], RotL(Add(x[ 4], x[ 0]),  9)); x[13] = Xor(x[13], RotL(Add(x[ 9], x[ 5]),  9));
+        x[ 2] = Xor(x[ 2], RotL(Add(x[14], x[10]),  9)); x[ 7] = Xor(x[ 7], RotL(Add(x[ 3], x[15]),  9));
+
+        x[12] = Xor(x[12], RotL(Add(x[ 8], x[ 4]), 13)); x[ 1] = Xor(x[ 1], RotL(Add(x[13], x[ 9]), 13));
+        x[ 6] = Xor(x[ 6], RotL(Add(x[ 2], x[14]), 13)); x[11] = Xor(x[11], RotL(Add(x[ 7], x[ 3]), 13));
+
+        x[ 0] = Xor(x[ 0], RotL(Add(x[12], x[ 8]), 18)); x[ 5] = Xor(x[ 5], RotL(Add(x[ 1], x[13]), 18));
+        x[10] = Xor(x[10], RotL(Add(x[ 6], x[ 2]), 18)); x[15] = Xor(x[15], RotL(Add(x[11], x[ 7]), 18));
+
+        /* Operate on rows. */
+        x[ 1] = Xor(x[ 1], RotL(Add(x[ 0], x[ 3]),  7)); x[ 6] = Xor(x[ 6], RotL(Add(x[ 5], x[ 4]),  7));
+        x[11] = Xor(x[11], RotL(Add(x[10], x[ 9]),  7)); x[12] = Xor(x[12], RotL(Add(x[15], x[14]),  7));
+
+        x[ 2] = Xor(x[ 2], RotL(Add(x[ 1], x[ 0]),  9)); x[ 7] = Xor(x[ 7], RotL(Add(x[ 6], x[ 5]),  9));
+        x[ 8] = Xor(x[ 8], RotL(Add(x[11], x[10]),  9)); x[13] = Xor(x[13], RotL(Add(x[12], x[15]),  9));
+
+        x[ 3] = Xor(x[ 3], RotL(Add(x[ 2], x[ 1]), 13)); x[ 4] = Xor(x[ 4], RotL(Add(x[ 7], x[ 6]), 13));
+        x[ 9] = Xor(x[ 9], RotL(Add(x[ 8], x[11]), 13)); x[14] = Xor(x[14], RotL(Add(x[13], x[12]), 13));
+
+        x[ 0] = Xor(x[ 0], RotL(Add(x[ 3], x[ 2]), 18)); x[ 5] = Xor(x[ 5], RotL(Add(x[ 4], x[ 7]), 18));
+        x[10] = Xor(x[10], RotL(Add(x[ 9], x[ 8]), 18)); x[15] = Xor(x[15], RotL(Add(x[14], x[13]), 18));
+    }
+    for (int i = 0; i < 16; i++) {
+        B[i] = Add(B[i], x[i]);
+    }
+}
+
+} // namespace
+
+/** Run scrypt's ROMix (N=1024, r=1) on eight lanes.
+ *  X holds 32 words per lane, lane after lane; V is a 64-byte aligned
+ *  scratchpad of 8 * 128 KiB, one contiguous region per lane so that the
+ *  data-dependent reads of the second loop stay within two cache lines. */
+void Core_8way(uint32_t* X, uint32_t* V)
+{
+    union {
+        __m256i v[32];
+        uint32_t u32[32][LANES];
+    } W;
+
+    for (int l = 0; l < LANES; l++) {
+        for (int k = 0; k < 32; k++) {
+            W.u32[k][l] = X[l * 32 + k];
+        }
+    }
+
+    for (uint32_t i = 0; i < 1024; i++) {
+        for (int l = 0; l < LANES; l++) {
+            uint32_t* Vi = V + l * LANE_WORDS + i * 32;
+            for (int k = 0; k < 32; k++) {
+                Vi[k] = W.u32[k][l];
+            }
+        }
+        XorSalsa8(&W.v[0], &W.v[16]);
+        XorSalsa8(&W.v[16], &W.v[0]);
+    }
+    for (uint32_t i = 0; i < 1024; i++) {
+        for (int l = 0; l < LANES; l++) {
+            const uint32_t* Vj = V + l * LANE_WORDS + 32 * (W.u32[16][l] & 1023);
+            for (int k = 0; k < 32; k++) {
+                W.u32[k][l] ^= Vj[k];
+            }
+        }
+        XorSalsa8(&W.v[0], &W.v[16]);
+        XorSalsa8(&W.v[16], &W.v[0]);
+    }
+
+    for (int l = 0; l < LANES; l++) {
+        for (int k = 0; k < 32; k++) {
+            X[l * 32 + k] = W.u32[k][l];
+        }
+    }
+}
+
+} // namespace scrypt_avx2
+
+#endif // ENABLE_AVX2
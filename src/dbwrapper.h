@@ -252,6 +252,49 @@ public:
         return true;
     }
 
+    /**
+     * Read the values of several keys from a single snapshot of the database.
+     * Keys are read in the order given, so sorted keys share the blocks they read.
+     * Returns whether each key was found; values of missing keys are left untouched.
+     */
+    template <typename K, typename V>
+    std::vector<bool> ReadMany(const std::vector<K>& keys, std::vector<V>& values) const
+    {
+        assert(keys.size() == values.size());
+
+        leveldb::ReadOptions options = readoptions;
+        options.snapshot = pdb->GetSnapshot();
+
+        std::vector<bool> found(keys.size(), false);
+        CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+        std::string strValue;
+        for (size_t i = 0; i < keys.size(); i++) {
+            ssKey.clear();
+            ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
+            ssKey << keys[i];
+            leveldb::Slice slKey(ssKey.data(), ssKey.size());
+
+            leveldb::Status status = pdb->Get(options, slKey, &strValue);
+            if (!status.ok()) {
+                if (status.IsNotFound())
+                    continue;
+                pdb->ReleaseSnapshot(options.snapshot);
+                LogPrintf("LevelDB read failure: %s\n", status.ToString());
+                dbwrapper_private::HandleError(status);
+            }
+            try {
+                CDataStream ssValue(strValue.data(), strValue.data() + strValue.size(), SER_DISK, CLIENT_VERSION);
+                ssValue.Xor(obfuscate_key);
+                ssValue >> values[i];
+                found[i] = true;
+            } catch (const std::exception&) {
+            }
+        }
+
+        pdb->ReleaseSnapshot(options.snapshot);
+        return found;
+    }
+
     template <typename K, typename V>
     bool Write(const K& key, const V& value, bool fSync = false)
     {
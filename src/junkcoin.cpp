@@ -10,6 +10,7 @@
 #include <junkcoin-fees.h>
 #include <pow.h>
 #include <auxpow.h>
+#include <crypto/scrypt.h>
 
 // Generate random number using Mersenne Twister
 int static generateMTRandom(unsigned int s, int range) {
@@ -71,7 +72,42 @@ unsigned int CalculateJunkcoinNextWorkRequired(bool fNewDifficultyProtocol, cons
     return bnNew.GetCompact();
 }
 
-bool CheckAuxPowProofOfWork(const CBlockHeader& block, const Consensus::Params& params) {
+uint256 GetAuxPowProofOfWorkHash(const CBlockHeader& block) {
+    if (block.auxpow) {
+        return block.auxpow->getParentBlockPoWHash();
+    }
+    return block.GetPoWHash();
+}
+
+std::vector<uint256> GetAuxPowProofOfWorkHashes(const std::vector<const CBlockHeader*>& headers) {
+    std::vector<char> inputs(headers.size() * 80);
+    std::vector<char> outputs(headers.size() * 32);
+    for (size_t i = 0; i < headers.size(); i++) {
+        const CBlockHeader& block = *headers[i];
+        CPureBlockHeader pure;
+        if (block.auxpow) {
+            pure = block.auxpow->parentBlock;
+        } else {
+            pure.nVersion = block.nVersion;
+            pure.hashPrevBlock = block.hashPrevBlock;
+            pure.hashMerkleRoot = block.hashMerkleRoot;
+            pure.nTime = block.nTime;
+            pure.nBits = block.nBits;
+            pure.nNonce = block.nNonce;
+        }
+        // Same 80-byte layout that CPureBlockHeader::GetPoWHash() hashes
+        memcpy(&inputs[i * 80], BEGIN(pure.nVersion), 80);
+    }
+    scrypt_1024_1_1_256_multi(inputs.data(), outputs.data(), headers.size());
+
+    std::vector<uint256> hashes(headers.size());
+    for (size_t i = 0; i < headers.size(); i++) {
+        memcpy(hashes[i].begin(), &outputs[i * 32], 32);
+    }
+    return hashes;
+}
+
+bool CheckAuxPowProofOfWork(const CBlockHeader& block, const Consensus::Params& params, const uint256* pow_hash) {
     // Verify chain ID for non-legacy blocks
     if (!block.IsLegacy() && params.fStrictChainId && block.GetChainId() != params.nAuxpowChainId) {
         return error("%s: block does not have our chain ID (got %d, expected %d, full nVersion %d)",
@@ -89,7 +125,7 @@ bool CheckAuxPowProofOfWork(const CBlockHeader& block, const Consensus::Params&
             return true;
         }
 
-        return CheckProofOfWork(block.GetPoWHash(), block.nBits, params);
+        return CheckProofOfWork(pow_hash ? *pow_hash : block.GetPoWHash(), block.nBits, params);
     }
 
     // Verify auxpow blocks
@@ -101,7 +137,7 @@ bool CheckAuxPowProofOfWork(const CBlockHeader& block, const Consensus::Params&
         return error("%s: AUX POW is not valid", __func__);
     }
 
-    return CheckProofOfWork(block.auxpow->getParentBlockPoWHash(), block.nBits, params);
+    return CheckProofOfWork(pow_hash ? *pow_hash : block.auxpow->getParentBlockPoWHash(), block.nBits, params);
 }
 
 CAmount GetJunkcoinBlockSubsidy(int nHeight, CAmount nFees, const Consensus::Params& consensusParams, uint256 prevHash) {
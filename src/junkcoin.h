@@ -18,10 +18,24 @@ bool ValidateBlockSubsidy(const CAmount nSubsidy, int nHeight, const Consensus::
 
 unsigned int CalculateJunkcoinNextWorkRequired(bool fNewDifficultyProtocol, const int64_t nTargetTimespanCurrent, const CBlockIndex* pindexLast, int64_t nLastRetargetTime, const Consensus::Params& params);
 
+/**
+ * Compute the scrypt hash that carries a block header's proof-of-work: the
+ * header's own PoW hash, or the parent block's for auxpow headers.
+ */
+uint256 GetAuxPowProofOfWorkHash(const CBlockHeader& block);
+
+/**
+ * Compute GetAuxPowProofOfWorkHash() for a batch of headers, running the
+ * scrypts through the multi-lane kernel (see scrypt_1024_1_1_256_multi()).
+ */
+std::vector<uint256> GetAuxPowProofOfWorkHashes(const std::vector<const CBlockHeader*>& headers);
+
 /**
  * Check proof-of-work of a block header, taking auxpow into account.
  * @param block The block header.
  * @param params Consensus parameters.
+ * @param pow_hash If not null, the known result of GetAuxPowProofOfWorkHash()
+ *                 for this header, which is used instead of rehashing.
  * @return True iff the PoW is correct.
  */
-bool CheckAuxPowProofOfWork(const CBlockHeader& block, const Consensus::Params& params);
+bool CheckAuxPowProofOfWork(const CBlockHeader& block, const Consensus::Params& params, const uint256* pow_hash = nullptr);
@@ -11,6 +11,12 @@
 class Bulletproofs
 {
 public:
+    //
+    // Resizes the cache of verified range proofs to at most the given number of bytes.
+    // Returns the number of proofs it can hold.
+    //
+    static size_t SetCacheSize(const size_t bytes);
+
     static bool BatchVerify(
         const std::vector<ProofData>& rangeProofs
     );
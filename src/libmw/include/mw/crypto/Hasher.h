@@ -71,6 +71,13 @@ private:
 extern mw::Hash Hashed(const std::vector<uint8_t>& serialized);
 extern mw::Hash Hashed(const Traits::ISerializable& serializable);
 
+//
+// Hashes many messages of the same length, which may be at most 1024 bytes.
+// The results match hashing each message on its own, but the messages are
+// compressed side by side using the widest SIMD backend the CPU supports.
+//
+extern std::vector<mw::Hash> HashedMany(const std::vector<const uint8_t*>& messages, const size_t length);
+
 template<class T>
 mw::Hash Hashed(const EHashTag tag, const T& serializable)
 {
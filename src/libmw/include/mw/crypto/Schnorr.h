@@ -10,6 +10,12 @@
 class Schnorr
 {
 public:
+    //
+    // Resizes the cache of verified signatures to at most the given number of bytes.
+    // Returns the number of signatures it can hold.
+    //
+    static size_t SetCacheSize(const size_t bytes);
+
     //
     // Signs the message hash with the given key.
     // If successful, returns a schnorr signature.
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <crypto/sha256.h>
+#include <cuckoocache.h>
+#include <random.h>
+#include <script/sigcache.h>
+#include <uint256.h>
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+//
+// Set of successfully verified range proofs, signatures or transaction
+// elements, in the style of the script signature cache. Entries are salted
+// SHA256 hashes of the verified data, stored in a CuckooCache so lookups
+// only take a shared lock.
+//
+class VerificationCache
+{
+public:
+    static constexpr size_t DEFAULT_SIZE = 4 << 20;
+
+    //
+    // Entries are SHA256(nonce || domain || 31 zero bytes || data),
+    // so caches for different kinds of data can't collide.
+    //
+    explicit VerificationCache(const unsigned char domain)
+    {
+        const uint256 nonce = GetRandHash();
+        const unsigned char padding[32] = { domain };
+        m_saltedHasher.Write(nonce.begin(), 32);
+        m_saltedHasher.Write(padding, 32);
+        m_cache->setup_bytes(DEFAULT_SIZE);
+    }
+
+    // Returns a hasher already salted, to write the entry's data to.
+    CSHA256 Hasher() const { return m_saltedHasher; }
+
+    bool Contains(const uint256& entry) const
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(m_mutex);
+        return m_cache->contains(entry, false);
+    }
+
+    void Insert(const std::vector<uint256>& entries)
+    {
+        std::unique_lock<std::shared_timed_mutex> lock(m_mutex);
+        for (const uint256& entry : entries) {
+            m_cache->insert(entry);
+        }
+    }
+
+    // Resizes the cache, dropping its entries. Returns the number of elements it can hold.
+    size_t SetupBytes(const size_t bytes)
+    {
+        // CuckooCache keeps its entries when resized to the same number of
+        // elements, so start from an empty cache.
+        std::unique_lock<std::shared_timed_mutex> lock(m_mutex);
+        m_cache = std::make_unique<Cache>();
+        return m_cache->setup_bytes(bytes);
+    }
+
+private:
+    using Cache = CuckooCache::cache<uint256, SignatureCacheHasher>;
+
+    CSHA256 m_saltedHasher;
+    std::unique_ptr<Cache> m_cache{std::make_unique<Cache>()};
+    mutable std::shared_timed_mutex m_mutex;
+};
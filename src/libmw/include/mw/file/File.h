@@ -2,7 +2,8 @@
 
 #include <mw/common/Traits.h>
 #include <mw/file/FilePath.h>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 class File : public Traits::IPrintable
 {
@@ -22,7 +23,8 @@ public:
 
     void Write(const std::vector<uint8_t>& bytes);
     void Write(const size_t startIndex, const std::vector<uint8_t>& bytes, const bool truncate);
-    void WriteBytes(const std::unordered_map<uint64_t, uint8_t>& bytes);
+    // Writes each chunk of bytes at its position, extending the file if needed
+    void WriteBytes(const std::vector<std::pair<uint64_t, std::vector<uint8_t>>>& chunks);
     void Truncate(const uint64_t size);
 
     void CopyTo(const FilePath& new_path) const;
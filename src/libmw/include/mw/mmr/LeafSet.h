@@ -6,7 +6,92 @@
 #include <mw/file/MemMap.h>
 #include <mw/models/crypto/Hash.h>
 #include <mw/mmr/LeafIndex.h>
-#include <unordered_map>
+
+#include <array>
+#include <vector>
+
+//
+// The words of a leafset that were modified, where a word holds 8 consecutive
+// bytes of the leafset (little-endian). Words are kept in pages of 64, each with
+// a bitmap of which of its words are dirty, so lookups and updates index straight
+// into a page without any hashing, and iterating costs O(pages + dirty words).
+//
+class DirtyWords
+{
+public:
+    bool empty() const noexcept { return m_numDirty == 0; }
+    size_t size() const noexcept { return m_numDirty; }
+
+    // Returns a pointer to the dirty word, or nullptr if it wasn't modified.
+    const uint64_t* Find(const uint64_t wordIdx) const noexcept
+    {
+        const uint64_t pageIdx = wordIdx / WORDS_PER_PAGE;
+        if (pageIdx >= m_pages.size() || !m_pages[pageIdx]) {
+            return nullptr;
+        }
+
+        const Page& page = *m_pages[pageIdx];
+        const uint64_t offset = wordIdx % WORDS_PER_PAGE;
+        return (page.dirty >> offset) & 1 ? &page.words[offset] : nullptr;
+    }
+
+    void Set(const uint64_t wordIdx, const uint64_t word)
+    {
+        const uint64_t pageIdx = wordIdx / WORDS_PER_PAGE;
+        if (pageIdx >= m_pages.size()) {
+            m_pages.resize(pageIdx + 1);
+        }
+
+        if (!m_pages[pageIdx]) {
+            m_pages[pageIdx] = std::make_unique<Page>();
+        }
+
+        Page& page = *m_pages[pageIdx];
+        const uint64_t offset = wordIdx % WORDS_PER_PAGE;
+        if (!((page.dirty >> offset) & 1)) {
+            page.dirty |= (uint64_t)1 << offset;
+            ++m_numDirty;
+        }
+
+        page.words[offset] = word;
+    }
+
+    // Calls fn(wordIdx, word) for each dirty word, in ascending order.
+    template <typename F>
+    void ForEach(const F& fn) const
+    {
+        for (uint64_t pageIdx = 0; pageIdx < m_pages.size(); pageIdx++) {
+            if (!m_pages[pageIdx]) {
+                continue;
+            }
+
+            const Page& page = *m_pages[pageIdx];
+            for (uint64_t offset = 0; offset < WORDS_PER_PAGE; offset++) {
+                if ((page.dirty >> offset) & 1) {
+                    fn((pageIdx * WORDS_PER_PAGE) + offset, page.words[offset]);
+                }
+            }
+        }
+    }
+
+    void clear() noexcept
+    {
+        m_pages.clear();
+        m_numDirty = 0;
+    }
+
+private:
+    static constexpr uint64_t WORDS_PER_PAGE = 64;
+
+    struct Page
+    {
+        uint64_t dirty = 0;
+        std::array<uint64_t, WORDS_PER_PAGE> words;
+    };
+
+    std::vector<std::unique_ptr<Page>> m_pages;
+    size_t m_numDirty = 0;
+};
 
 class ILeafSet
 {
@@ -15,8 +100,9 @@ public:
 
     virtual ~ILeafSet() = default;
 
-    virtual uint8_t GetByte(const uint64_t byteIdx) const = 0;
-    virtual void SetByte(const uint64_t byteIdx, const uint8_t value) = 0;
+    // Each word holds the bits of 64 leaves, as 8 leafset bytes in little-endian order.
+    virtual uint64_t GetWord(const uint64_t wordIdx) const = 0;
+    virtual void SetWord(const uint64_t wordIdx, const uint64_t word) = 0;
 
     void Add(const mmr::LeafIndex& idx);
     void Remove(const mmr::LeafIndex& idx);
@@ -27,14 +113,25 @@ public:
     uint64_t GetNumNodes() const noexcept { return GetNextLeafIdx().GetPosition(); }
     BitSet ToBitSet() const;
 
+    // Counts the unspent leaves, using a popcount per word.
+    uint64_t GetNumUnspent() const { return GetNumUnspent(m_nextLeafIdx); }
+
+    // Counts the unspent leaves before the given leaf index.
+    uint64_t GetNumUnspent(const mmr::LeafIndex& endIdx) const;
+
     virtual void ApplyUpdates(
         const uint32_t file_index,
         const mmr::LeafIndex& nextLeafIdx,
-        const std::unordered_map<uint64_t, uint8_t>& modifiedBytes
+        const DirtyWords& modifiedWords
     ) = 0;
 
 protected:
-    uint8_t BitToByte(const uint8_t bit) const;
+    // Returns the word's mask for the leaf.
+    // Example: Leaf 10 is bit 5 (00100000) of byte 1, so its mask is 0x2000.
+    static uint64_t LeafMask(const mmr::LeafIndex& idx) noexcept;
+
+    // Removes all leaves at or after the given number of leaves.
+    void RemoveFrom(const uint64_t numLeaves);
 
     ILeafSet(const mmr::LeafIndex& nextLeafIdx)
         : m_nextLeafIdx(nextLeafIdx) { }
@@ -50,13 +147,13 @@ public:
     static LeafSet::Ptr Open(const FilePath& leafset_dir, const uint32_t file_index);
     static FilePath GetPath(const FilePath& leafset_dir, const uint32_t file_index);
 
-    uint8_t GetByte(const uint64_t byteIdx) const final;
-    void SetByte(const uint64_t byteIdx, const uint8_t value) final;
+    uint64_t GetWord(const uint64_t wordIdx) const final;
+    void SetWord(const uint64_t wordIdx, const uint64_t word) final;
 
     void ApplyUpdates(
         const uint32_t file_index,
         const mmr::LeafIndex& nextLeafIdx,
-        const std::unordered_map<uint64_t, uint8_t>& modifiedBytes
+        const DirtyWords& modifiedWords
     ) final;
     void Flush(const uint32_t file_index);
     void Cleanup(const uint32_t current_file_index) const;
@@ -67,7 +164,7 @@ private:
 
     FilePath m_dir;
     MemMap m_mmap;
-    std::unordered_map<uint64_t, uint8_t> m_modifiedBytes;
+    DirtyWords m_modifiedWords;
 };
 
 class LeafSetCache : public ILeafSet
@@ -79,17 +176,17 @@ public:
     LeafSetCache(const ILeafSet::Ptr& pBacked)
         : ILeafSet(pBacked->GetNextLeafIdx()), m_pBacked(pBacked) { }
 
-    uint8_t GetByte(const uint64_t byteIdx) const final;
-    void SetByte(const uint64_t byteIdx, const uint8_t value) final;
+    uint64_t GetWord(const uint64_t wordIdx) const final;
+    void SetWord(const uint64_t wordIdx, const uint64_t word) final;
 
     void ApplyUpdates(
         const uint32_t file_index,
         const mmr::LeafIndex& nextLeafIdx,
-        const std::unordered_map<uint64_t, uint8_t>& modifiedBytes
+        const DirtyWords& modifiedWords
     ) final;
     void Flush(const uint32_t file_index);
 
 private:
     ILeafSet::Ptr m_pBacked;
-    std::unordered_map<uint64_t, uint8_t> m_modifiedBytes;
+    DirtyWords m_modifiedWords;
 };
\ No newline at end of file
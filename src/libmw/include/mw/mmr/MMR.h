@@ -31,6 +31,29 @@ public:
     mmr::LeafIndex Add(const std::vector<uint8_t>& data) { return AddLeaf(mmr::Leaf::Create(GetNextLeafIdx(), data)); }
     mmr::LeafIndex Add(const Traits::ISerializable& serializable) { return AddLeaf(mmr::Leaf::Create(GetNextLeafIdx(), serializable.Serialized())); }
 
+    /// <summary>
+    /// Adds the given leaves to the end of the MMR.
+    /// Equivalent to calling AddLeaf for each leaf, but the new parent hashes
+    /// are calculated one level at a time, so each level is hashed in a single batch.
+    /// </summary>
+    /// <param name="leaves">The leaves to add, starting at GetNextLeafIdx().</param>
+    virtual void AddLeaves(const std::vector<mmr::Leaf>& leaves) = 0;
+
+    template <class T>
+    void AddAll(const std::vector<T>& serializables)
+    {
+        std::vector<mmr::Leaf> leaves;
+        leaves.reserve(serializables.size());
+
+        mmr::LeafIndex leafIdx = GetNextLeafIdx();
+        for (const T& serializable : serializables) {
+            leaves.push_back(mmr::Leaf::Create(leafIdx, serializable.Serialized()));
+            leafIdx = leafIdx.Next();
+        }
+
+        AddLeaves(leaves);
+    }
+
     /// <summary>
     /// Retrieves the leaf at the given leaf index.
     /// </summary>
@@ -49,6 +72,14 @@ public:
     /// <throws>std::exception if node at the given index has been pruned.</throws>
     virtual mw::Hash GetHash(const mmr::Index& idx) const = 0;
 
+    /// <summary>
+    /// Checks whether the leaf at the given index was removed from the MMR files by compaction.
+    /// The hash and data of a compacted leaf are no longer available, so it can't be unspent.
+    /// </summary>
+    /// <param name="leafIdx">The leaf index.</param>
+    /// <returns>True if the leaf has been compacted.</returns>
+    virtual bool IsCompacted(const mmr::LeafIndex& leafIdx) const noexcept = 0;
+
     /// <summary>
     /// Retrieves the index of the next leaf to be added to the MMR.
     /// eg. If the MMR contains 3 leaves (0, 1, 2), this will return LeafIndex 3.
@@ -115,8 +146,10 @@ public:
     virtual ~MemMMR() = default;
 
     mmr::LeafIndex AddLeaf(const mmr::Leaf& leaf) final;
+    void AddLeaves(const std::vector<mmr::Leaf>& leaves) final;
     mmr::Leaf GetLeaf(const mmr::LeafIndex& leafIdx) const final;
     mw::Hash GetHash(const mmr::Index& idx) const final;
+    bool IsCompacted(const mmr::LeafIndex&) const noexcept final { return false; }
 
     mmr::LeafIndex GetNextLeafIdx() const noexcept final;
     uint64_t GetNumLeaves() const noexcept final;
@@ -163,9 +196,11 @@ public:
     static FilePath GetPath(const FilePath& dir, const char prefix, const uint32_t file_index);
 
     mmr::LeafIndex AddLeaf(const mmr::Leaf& leaf) final;
+    void AddLeaves(const std::vector<mmr::Leaf>& leaves) final;
 
     mmr::Leaf GetLeaf(const mmr::LeafIndex& leafIdx) const final;
     mw::Hash GetHash(const mmr::Index& idx) const final;
+    bool IsCompacted(const mmr::LeafIndex& leafIdx) const noexcept final;
     mmr::LeafIndex GetNextLeafIdx() const noexcept final { return mmr::LeafIndex::At(GetNumLeaves()); }
 
     uint64_t GetNumLeaves() const noexcept final;
@@ -180,6 +215,17 @@ public:
     ) final;
     void Cleanup(const uint32_t current_file_index) const;
 
+    /// <summary>
+    /// Rewrites the hash file without the given compacted nodes, and removes the data of compacted leaves from the database.
+    /// The new hash file and prune list are written with the given file index, and the MMR switches to them once written.
+    /// The old files are left in place, so the MMR can still be reopened from them until the batch is committed.
+    /// </summary>
+    /// <param name="file_index">The index of the new hash and prune list files.</param>
+    /// <param name="compacted">The positions of all compacted nodes. Must include the currently compacted nodes.</param>
+    /// <param name="pBatch">A wrapper around a DB Batch. Compacted leaves are removed in this batch.</param>
+    void Compact(const uint32_t file_index, const BitSet& compacted, const std::unique_ptr<mw::DBBatch>& pBatch);
+    const PruneList::CPtr& GetPruneList() const noexcept { return m_pPruneList; }
+
 private:
     char m_dbPrefix;
     FilePath m_dir;
@@ -200,11 +246,13 @@ public:
     virtual ~PMMRCache() = default;
 
     mmr::LeafIndex AddLeaf(const mmr::Leaf& leaf) final;
+    void AddLeaves(const std::vector<mmr::Leaf>& leaves) final;
 
     mmr::Leaf GetLeaf(const mmr::LeafIndex& leafIdx) const final;
     mmr::LeafIndex GetNextLeafIdx() const noexcept final;
     uint64_t GetNumLeaves() const noexcept final { return GetNextLeafIdx().Get(); }
     mw::Hash GetHash(const mmr::Index& idx) const final;
+    bool IsCompacted(const mmr::LeafIndex& leafIdx) const noexcept final;
 
     void Rewind(const uint64_t numLeaves) final;
 
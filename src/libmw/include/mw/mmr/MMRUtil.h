@@ -2,6 +2,7 @@
 
 #include <mw/common/BitSet.h>
 #include <mw/mmr/Index.h>
+#include <mw/mmr/Leaf.h>
 #include <mw/mmr/LeafIndex.h>
 
 class IMMR;
@@ -10,6 +11,15 @@ class MMRUtil
 {
 public:
     static mw::Hash CalcParentHash(const mmr::Index& index, const mw::Hash& left_hash, const mw::Hash& right_hash);
+
+    /// <summary>
+    /// Calculates the hashes of the nodes added to the MMR when appending the given leaves.
+    /// Parents are built one level at a time, and all parent hashes of a level are calculated together.
+    /// </summary>
+    /// <param name="mmr">The MMR being appended to.</param>
+    /// <param name="leaves">The leaves being appended, starting at mmr.GetNextLeafIdx().</param>
+    /// <returns>The hashes of the new leaves and parents, ordered by position.</returns>
+    static std::vector<mw::Hash> CalcAppendedHashes(const IMMR& mmr, const std::vector<mmr::Leaf>& leaves);
     static std::vector<mmr::Index> CalcPeakIndices(const uint64_t num_nodes);
     static boost::optional<mw::Hash> CalcBaggedPeak(const IMMR& mmr, const mmr::Index& peak_idx);
 
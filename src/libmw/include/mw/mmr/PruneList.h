@@ -19,6 +19,9 @@ public:
     uint64_t GetShift(const mmr::LeafIndex& index) const noexcept;
     uint64_t GetTotalShift() const noexcept { return m_totalShift; }
 
+    bool IsCompacted(const mmr::Index& index) const noexcept { return m_compacted.test(index.GetPosition()); }
+    const BitSet& GetCompacted() const noexcept { return m_compacted; }
+
     void Commit(const uint32_t file_index, const BitSet& compacted);
 
 private:
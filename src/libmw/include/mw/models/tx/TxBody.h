@@ -102,8 +102,24 @@ public:
         READWRITE(obj.m_inputs, obj.m_outputs, obj.m_kernels);
     }
 
+    //
+    // Validates the body. The signatures and range proofs of kernels, inputs,
+    // and outputs that were already cached by MarkVerified() are not checked again.
+    //
     void Validate() const;
 
+    //
+    // Adds the kernels, inputs, and outputs to the cache of verified elements.
+    // Only call this once the transaction containing them has been fully validated.
+    //
+    void MarkVerified() const;
+
+    //
+    // Resizes the cache of verified elements to at most the given number of bytes.
+    // Returns the number of kernels, inputs, and outputs it can hold.
+    //
+    static size_t SetCacheSize(const size_t bytes);
+
 private:
     // List of inputs spent by the transaction.
     std::vector<Input> m_inputs;
@@ -128,7 +128,7 @@ public:
     IMMR::Ptr GetOutputPMMR() const noexcept final { return m_pOutputPMMR; }
 
 private:
-    void AddUTXO(const uint64_t header_height, const Output& output);
+    void AddUTXOs(const uint64_t header_height, const std::vector<Output>& outputs);
     UTXO SpendUTXO(const mw::Hash& output_id);
 
     ICoinsView::Ptr m_pBase;
@@ -160,6 +160,17 @@ public:
     ) final;
     void Compact() const final;
 
+    /// <summary>
+    /// Rewrites the output PMMR files without the subtrees that were fully spent as of the horizon header.
+    /// Leaves spent after the horizon are kept, so blocks above the horizon can still be disconnected,
+    /// but blocks at or below the horizon can no longer be disconnected once compacted.
+    /// This must only be called when there are no unflushed changes.
+    /// </summary>
+    /// <param name="pHorizonHeader">The header of the last block that won't be disconnected.</param>
+    /// <param name="spent_since_horizon">The leaves spent by blocks above the horizon.</param>
+    /// <returns>True if the MMR was compacted. False if there wasn't enough to compact.</returns>
+    bool CompactMMR(const mw::Header::CPtr& pHorizonHeader, const std::vector<mmr::LeafIndex>& spent_since_horizon);
+
     ILeafSet::Ptr GetLeafSet() const noexcept final { return m_pLeafSet; }
     IMMR::Ptr GetOutputPMMR() const noexcept final { return m_pOutputPMMR; }
 
@@ -167,11 +178,13 @@ public:
 
 private:
     CoinsViewDB(
+        const FilePath& datadir,
         const mw::Header::CPtr& pBestHeader,
         const mw::DBWrapper::Ptr& pDBWrapper,
         const LeafSet::Ptr& pLeafSet,
         const PMMR::Ptr& pOutputPMMR
     ) : ICoinsView(pBestHeader, pDBWrapper),
+        m_datadir(datadir),
         m_pLeafSet(pLeafSet),
         m_pOutputPMMR(pOutputPMMR) { }
 
@@ -180,6 +193,7 @@ private:
     void SpendUTXO(CoinDB& coinDB, const mw::Hash& output_id);
     UTXO::CPtr GetUTXO(const CoinDB& coinDB, const mw::Hash& output_id) const;
 
+    FilePath m_datadir;
     LeafSet::Ptr m_pLeafSet;
     PMMR::Ptr m_pOutputPMMR;
 };
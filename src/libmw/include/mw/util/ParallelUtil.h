@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <vector>
+
+class ParallelUtil
+{
+public:
+    //
+    // Sets the number of threads (including the caller's) that batch
+    // verification may use. Defaults to 1; the node matches it to -par.
+    //
+    static void SetThreads(const size_t threads) { Threads() = std::max<size_t>(threads, 1); }
+    static size_t GetThreads() { return Threads(); }
+
+    //
+    // Splits [0, count) into contiguous chunks of at least min_chunk items,
+    // at most one per thread, and calls fn(begin, end) for each.
+    // The first chunk runs on the calling thread.
+    // Returns true if every call returned true.
+    //
+    static bool ForEachChunk(const size_t count, const size_t min_chunk, const std::function<bool(size_t, size_t)>& fn)
+    {
+        const size_t num_chunks = std::max<size_t>(std::min(GetThreads(), count / std::max<size_t>(min_chunk, 1)), 1);
+        const size_t chunk_size = (count + num_chunks - 1) / num_chunks;
+
+        std::vector<std::future<bool>> futures;
+        for (size_t begin = chunk_size; begin < count; begin += chunk_size) {
+            futures.push_back(std::async(std::launch::async, fn, begin, std::min(begin + chunk_size, count)));
+        }
+
+        bool result = fn(0, std::min(chunk_size, count));
+        for (auto& future : futures) {
+            result = future.get() && result;
+        }
+
+        return result;
+    }
+
+private:
+    static std::atomic<size_t>& Threads()
+    {
+        static std::atomic<size_t> threads{1};
+        return threads;
+    }
+};
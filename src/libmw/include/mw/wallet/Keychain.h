@@ -28,6 +28,11 @@ public:
     // used to calculate the spend key when the wallet becomes unlocked.
     bool RewindOutput(const Output& output, mw::Coin& coin) const;
 
+    // Checks the view tags of the outputs, split across threads.
+    // That check is most of the cost of rewinding an output that isn't ours,
+    // so only the returned indices need to be passed to RewindOutput.
+    std::vector<size_t> ScanOutputs(const std::vector<Output>& outputs) const;
+
     // Calculates the output secret key for the given coin.
     // If the address index is known, it calculates from the keychain's master spend key.
     // If not, it attempts to lookup the spend key in the database.
@@ -1,20 +1,24 @@
 #include <mw/crypto/Bulletproofs.h>
 #include "Context.h"
 #include "ConversionUtil.h"
+#include "ScratchSpace.h"
 
-#include <caches/Cache.h>
+#include <mw/crypto/VerificationCache.h>
 #include <mw/exceptions/CryptoException.h>
+#include <mw/util/ParallelUtil.h>
 #include <mw/util/VectorUtil.h>
 
-static constexpr uint64_t MAX_WIDTH = 1 << 20;
-static constexpr size_t SCRATCH_SPACE_SIZE = 256 * MAX_WIDTH;
 static constexpr size_t PROOF_LEN = 675;
 static constexpr size_t NUM_BITS_PROVEN = 64;
 
-static Locked<LRUCache<Commitment, ProofData>> CACHE(std::make_shared<LRUCache<Commitment, ProofData>>(3000));
+static VerificationCache CACHE('B');
 static Locked<Context> BP_CONTEXT(std::make_shared<Context>());
 
-bool Bulletproofs::BatchVerify(const std::vector<ProofData>& proofs)
+// Fewer proofs than this aren't worth a thread of their own,
+// since splitting a batch gives up some of the multi-exponentiation savings.
+static constexpr size_t MIN_PROOFS_PER_THREAD = 8;
+
+static bool VerifyProofs(const std::vector<const ProofData*>& proofs)
 {
     std::vector<secp256k1_pedersen_commitment> secpCommitments;
     secpCommitments.reserve(proofs.size());
@@ -28,44 +32,31 @@ bool Bulletproofs::BatchVerify(const std::vector<ProofData>& proofs)
     std::vector<size_t> extraDataLen;
     extraDataLen.reserve(proofs.size());
 
-    for (const auto& proof : proofs)
+    for (const ProofData* pProof : proofs)
     {
-        auto cache_writer = CACHE.Write();
-        if (!cache_writer->Cached(proof.commitment) || proof != cache_writer->Get(proof.commitment)) {
-            secpCommitments.push_back(ConversionUtil::ToSecp256k1(proof.commitment));
-            bulletproofPointers.emplace_back(proof.pRangeProof->data());
-
-            if (!proof.extraData.empty()) {
-                extraData.push_back(proof.extraData.data());
-                extraDataLen.push_back(proof.extraData.size());
-            } else {
-                extraData.push_back(nullptr);
-                extraDataLen.push_back(0);
-            }
+        secpCommitments.push_back(ConversionUtil::ToSecp256k1(pProof->commitment));
+        bulletproofPointers.emplace_back(pProof->pRangeProof->data());
+
+        if (!pProof->extraData.empty()) {
+            extraData.push_back(pProof->extraData.data());
+            extraDataLen.push_back(pProof->extraData.size());
+        } else {
+            extraData.push_back(nullptr);
+            extraDataLen.push_back(0);
         }
     }
 
-    if (secpCommitments.empty()) {
-        return true;
-    }
-
     // array of generator multiplied by value in pedersen commitments (cannot be NULL)
-    std::vector<secp256k1_generator> valueGenerators;
-    for (size_t i = 0; i < secpCommitments.size(); i++)
-    {
-        valueGenerators.push_back(secp256k1_generator_const_h);
-    }
+    std::vector<secp256k1_generator> valueGenerators(secpCommitments.size(), secp256k1_generator_const_h);
 
     std::vector<secp256k1_pedersen_commitment*> commitmentPointers = VectorUtil::ToPointerVec(secpCommitments);
 
-    secp256k1_scratch_space* pScratchSpace = secp256k1_scratch_space_create(
-        BP_CONTEXT.Read()->Get(),
-        SCRATCH_SPACE_SIZE
-    );
+    auto context = BP_CONTEXT.Read();
+    ScratchSpace scratch(context->Get(), proofs.size());
     const int result = secp256k1_bulletproof_rangeproof_verify_multi(
-        BP_CONTEXT.Read()->Get(),
-        pScratchSpace,
-        BP_CONTEXT.Read()->GetGenerators(),
+        context->Get(),
+        scratch.Get(),
+        context->GetGenerators(),
         bulletproofPointers.data(),
         secpCommitments.size(),
         PROOF_LEN,
@@ -77,17 +68,61 @@ bool Bulletproofs::BatchVerify(const std::vector<ProofData>& proofs)
         extraData.data(),
         extraDataLen.data()
     );
-    secp256k1_scratch_space_destroy(pScratchSpace);
 
-    if (result == 1) {
-        auto cache_writer = CACHE.Write();
-        for (const auto& proof : proofs)
-        {
-            cache_writer->Put(proof.commitment, proof);
+    return result == 1;
+}
+
+static uint256 CacheEntry(const ProofData& proof)
+{
+    uint256 entry;
+    CACHE.Hasher()
+        .Write(proof.commitment.data(), proof.commitment.size())
+        .Write(proof.pRangeProof->data(), proof.pRangeProof->size())
+        .Write(proof.extraData.data(), proof.extraData.size())
+        .Finalize(entry.begin());
+    return entry;
+}
+
+size_t Bulletproofs::SetCacheSize(const size_t bytes)
+{
+    return CACHE.SetupBytes(bytes);
+}
+
+bool Bulletproofs::BatchVerify(const std::vector<ProofData>& proofs)
+{
+    std::vector<const ProofData*> unverified;
+    unverified.reserve(proofs.size());
+
+    std::vector<uint256> entries;
+    entries.reserve(proofs.size());
+
+    for (const auto& proof : proofs)
+    {
+        uint256 entry = CacheEntry(proof);
+        if (!CACHE.Contains(entry)) {
+            unverified.push_back(&proof);
+            entries.push_back(std::move(entry));
         }
     }
 
-    return result == 1;
+    if (unverified.empty()) {
+        return true;
+    }
+
+    // Large batches are split into chunks that are verified in parallel
+    const bool verified = ParallelUtil::ForEachChunk(
+        unverified.size(),
+        MIN_PROOFS_PER_THREAD,
+        [&unverified](const size_t begin, const size_t end) {
+            return VerifyProofs(std::vector<const ProofData*>(unverified.begin() + begin, unverified.begin() + end));
+        }
+    );
+
+    if (verified) {
+        CACHE.Insert(entries);
+    }
+
+    return verified;
 }
 
 RangeProof::CPtr Bulletproofs::Generate(
@@ -104,12 +139,12 @@ RangeProof::CPtr Bulletproofs::Generate(
     std::vector<uint8_t> proofBytes(RangeProof::SIZE, 0);
     size_t proofLen = RangeProof::SIZE;
 
-    secp256k1_scratch_space* pScratchSpace = secp256k1_scratch_space_create(pContext, SCRATCH_SPACE_SIZE);
+    ScratchSpace scratch(pContext, 1);
 
     std::vector<const uint8_t*> blindingFactors({ key.data() });
     int result = secp256k1_bulletproof_rangeproof_prove(
         pContext,
-        pScratchSpace,
+        scratch.Get(),
         contextWriter->GetGenerators(),
         &proofBytes[0],
         &proofLen,
@@ -129,7 +164,6 @@ RangeProof::CPtr Bulletproofs::Generate(
         extraData.size(),
         proofMessage.data()
     );
-    secp256k1_scratch_space_destroy(pScratchSpace);
 
     if (result != 1) {
         ThrowCrypto_F("secp256k1_bulletproof_rangeproof_prove failed with error: {}", result);
@@ -1,9 +1,23 @@
 #include <mw/crypto/Hasher.h>
 
+#include <cassert>
+
+#if defined(HAVE_CONFIG_H)
+#include <config/bitcoin-config.h>
+#endif
+
+// SSE2 is part of the x86-64 baseline. The SSE4.1 and AVX2 backends live in
+// Hasher_sse41.cpp and Hasher_avx2.cpp, built with the matching compiler flags.
 #define BLAKE3_NO_AVX512 1
+#if !defined(ENABLE_AVX2) || defined(BUILD_BITCOIN_INTERNAL)
 #define BLAKE3_NO_AVX2 1
+#endif
+#if !defined(ENABLE_SSE41) || defined(BUILD_BITCOIN_INTERNAL)
 #define BLAKE3_NO_SSE41 1
+#endif
+#if !defined(__x86_64__) && !defined(_M_X64)
 #define BLAKE3_NO_SSE2 1
+#endif
 extern "C" {
 #include <crypto/blake3/blake3.c>
 #include <crypto/blake3/blake3_dispatch.c>
@@ -20,4 +34,37 @@ mw::Hash Hashed(const std::vector<uint8_t>& serialized)
 mw::Hash Hashed(const Traits::ISerializable& serializable)
 {
     return Hashed(serializable.Serialized());
-}
\ No newline at end of file
+}
+std::vector<mw::Hash> HashedMany(const std::vector<const uint8_t*>& messages, const size_t length)
+{
+    assert(length > 0 && length <= BLAKE3_CHUNK_LEN);
+
+    // All blocks but the last are compressed for every message at once.
+    // The last block is shorter, or is the root, so it's finished per message.
+    const size_t num_blocks = (length - 1) / BLAKE3_BLOCK_LEN;
+    const size_t last_block_len = length - (num_blocks * BLAKE3_BLOCK_LEN);
+
+    std::vector<uint8_t> cvs(messages.size() * BLAKE3_OUT_LEN);
+    if (num_blocks > 0) {
+        blake3_hash_many(messages.data(), messages.size(), num_blocks, IV, 0, false, 0, CHUNK_START, 0, cvs.data());
+    }
+
+    std::vector<mw::Hash> hashes(messages.size());
+    for (size_t i = 0; i < messages.size(); i++) {
+        uint32_t cv[8];
+        if (num_blocks > 0) {
+            load_key_words(&cvs[i * BLAKE3_OUT_LEN], cv);
+        } else {
+            memcpy(cv, IV, sizeof(cv));
+        }
+
+        uint8_t block[BLAKE3_BLOCK_LEN] = { 0 };
+        memcpy(block, messages[i] + (num_blocks * BLAKE3_BLOCK_LEN), last_block_len);
+
+        const uint8_t flags = CHUNK_END | ROOT | (num_blocks == 0 ? CHUNK_START : 0);
+        blake3_compress_in_place(cv, block, (uint8_t)last_block_len, 0, flags);
+        store_cv_words(hashes[i].data(), cv);
+    }
+
+    return hashes;
+}
@@ -0,0 +1,9 @@
+// Built into libbitcoin_crypto_avx2 with the compiler flags it needs.
+// See Hasher.cpp for how the backend is selected.
+#ifdef ENABLE_AVX2
+
+extern "C" {
+#include <crypto/blake3/blake3_avx2.c>
+}
+
+#endif
@@ -0,0 +1,9 @@
+// Kept apart from Hasher.cpp, since the backends' helpers share names.
+// SSE2 is part of the x86-64 baseline, so no extra compiler flags are needed.
+#if defined(__x86_64__) || defined(_M_X64)
+
+extern "C" {
+#include <crypto/blake3/blake3_sse2.c>
+}
+
+#endif
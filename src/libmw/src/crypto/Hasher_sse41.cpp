@@ -0,0 +1,9 @@
+// Built into libbitcoin_crypto_sse41 with the compiler flags it needs.
+// See Hasher.cpp for how the backend is selected.
+#ifdef ENABLE_SSE41
+
+extern "C" {
+#include <crypto/blake3/blake3_sse41.c>
+}
+
+#endif
@@ -1,17 +1,32 @@
 #include <mw/crypto/Schnorr.h>
 #include "Context.h"
 #include "ConversionUtil.h"
+#include "ScratchSpace.h"
 
-#include <caches/Cache.h>
 #include <mw/common/Logger.h>
+#include <mw/crypto/VerificationCache.h>
 #include <mw/exceptions/CryptoException.h>
+#include <mw/util/ParallelUtil.h>
 #include <mw/util/VectorUtil.h>
 
-static Locked<LRUCache<SignedMessage, bool>> CACHE(std::make_shared<LRUCache<SignedMessage, bool>>(3000));
+static VerificationCache CACHE('S');
 static Locked<Context> SCHNORR_CONTEXT(std::make_shared<Context>());
 
-static constexpr uint64_t MAX_WIDTH = 1 << 20;
-static constexpr size_t SCRATCH_SPACE_SIZE = 256 * MAX_WIDTH;
+static uint256 CacheEntry(const SignedMessage& signed_message)
+{
+    uint256 entry;
+    CACHE.Hasher()
+        .Write(signed_message.GetPublicKey().data(), signed_message.GetPublicKey().size())
+        .Write(signed_message.GetMsgHash().data(), signed_message.GetMsgHash().size())
+        .Write(signed_message.GetSignature().data(), Signature::SIZE)
+        .Finalize(entry.begin());
+    return entry;
+}
+
+size_t Schnorr::SetCacheSize(const size_t bytes)
+{
+    return CACHE.SetupBytes(bytes);
+}
 
 Signature Schnorr::Sign(
     const uint8_t* secretKey,
@@ -49,8 +64,8 @@ bool Schnorr::Verify(
     const PublicKey& sumPubKeys,
     const mw::Hash& message)
 {
-    SignedMessage signed_message(message, sumPubKeys, signature);
-    if (CACHE.Write()->Cached(signed_message)) {
+    const uint256 entry = CacheEntry(SignedMessage(message, sumPubKeys, signature));
+    if (CACHE.Contains(entry)) {
         return true;
     }
 
@@ -67,56 +82,75 @@ bool Schnorr::Verify(
         false
     );
     if (verifyResult == 1) {
-        CACHE.Write()->Put(signed_message, true);
+        CACHE.Insert({ entry });
     }
 
     return verifyResult == 1;
 }
 
-bool Schnorr::BatchVerify(const std::vector<SignedMessage>& signatures)
+// Fewer signatures than this aren't worth a thread of their own
+static constexpr size_t MIN_SIGNATURES_PER_THREAD = 32;
+
+static bool VerifySignatures(const std::vector<const SignedMessage*>& messages)
 {
-    std::vector<SignedMessage> unverified_messages;
     std::vector<secp256k1_pubkey> parsedPubKeys;
     std::vector<secp256k1_schnorrsig> parsedSignatures;
     std::vector<const uint8_t*> messageData;
 
-    for (const SignedMessage& signed_message : signatures) {
-        if (CACHE.Write()->Cached(signed_message)) {
-            continue;
-        }
-
-        unverified_messages.push_back(signed_message);
-        parsedPubKeys.push_back(ConversionUtil::ToSecp256k1(signed_message.GetPublicKey()));
-        parsedSignatures.push_back(ConversionUtil::ToSecp256k1(signed_message.GetSignature()));
-        messageData.push_back(signed_message.GetMsgHash().data());
-    }
-
-    if (unverified_messages.empty()) {
-        return true;
+    for (const SignedMessage* pMessage : messages) {
+        parsedPubKeys.push_back(ConversionUtil::ToSecp256k1(pMessage->GetPublicKey()));
+        parsedSignatures.push_back(ConversionUtil::ToSecp256k1(pMessage->GetSignature()));
+        messageData.push_back(pMessage->GetMsgHash().data());
     }
 
     std::vector<secp256k1_pubkey*> pubKeyPtrs = VectorUtil::ToPointerVec(parsedPubKeys);
     std::vector<secp256k1_schnorrsig*> signaturePtrs = VectorUtil::ToPointerVec(parsedSignatures);
 
-    secp256k1_scratch_space* pScratchSpace = secp256k1_scratch_space_create(
-        SCHNORR_CONTEXT.Read()->Get(),
-        SCRATCH_SPACE_SIZE
-    );
+    auto context = SCHNORR_CONTEXT.Read();
+    ScratchSpace scratch(context->Get(), messages.size());
     const int verifyResult = secp256k1_schnorrsig_verify_batch(
-        SCHNORR_CONTEXT.Read()->Get(),
-        pScratchSpace,
+        context->Get(),
+        scratch.Get(),
         signaturePtrs.data(),
         messageData.data(),
         pubKeyPtrs.data(),
-        unverified_messages.size()
+        messages.size()
     );
-    secp256k1_scratch_space_destroy(pScratchSpace);
 
-    if (verifyResult == 1) {
-        for (const SignedMessage& message : unverified_messages) {
-            CACHE.Write()->Put(message, true);
+    return verifyResult == 1;
+}
+
+bool Schnorr::BatchVerify(const std::vector<SignedMessage>& signatures)
+{
+    std::vector<const SignedMessage*> unverified_messages;
+    std::vector<uint256> entries;
+
+    for (const SignedMessage& signed_message : signatures) {
+        uint256 entry = CacheEntry(signed_message);
+        if (CACHE.Contains(entry)) {
+            continue;
         }
+
+        unverified_messages.push_back(&signed_message);
+        entries.push_back(std::move(entry));
     }
 
-    return verifyResult == 1;
+    if (unverified_messages.empty()) {
+        return true;
+    }
+
+    // Large batches are split into chunks that are verified in parallel
+    const bool verified = ParallelUtil::ForEachChunk(
+        unverified_messages.size(),
+        MIN_SIGNATURES_PER_THREAD,
+        [&unverified_messages](const size_t begin, const size_t end) {
+            return VerifySignatures(std::vector<const SignedMessage*>(unverified_messages.begin() + begin, unverified_messages.begin() + end));
+        }
+    );
+
+    if (verified) {
+        CACHE.Insert(entries);
+    }
+
+    return verified;
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "secp256k1-zkp.h"
+
+//
+// Scratch space for secp256k1 batch operations.
+//
+// Each thread keeps one scratch space that is reused across calls, so the
+// frames allocated by previous batches don't have to be allocated again.
+// Batches wider than MAX_POOLED_WIDTH, or a nested use on the same thread,
+// get a scratch space of their own that is freed afterwards. That bounds
+// the memory each thread holds on to between calls.
+//
+class ScratchSpace
+{
+public:
+    // Upper bound on what a single batch may allocate. Frames are sized to
+    // the batch, so this is never allocated up front.
+    static constexpr size_t MAX_SIZE = 256 * (1 << 20);
+
+    // Widest batch (in proofs or signatures) that uses the thread's scratch space.
+    static constexpr size_t MAX_POOLED_WIDTH = 256;
+
+    ScratchSpace(const secp256k1_context* pContext, const size_t width)
+        : m_pooled(width <= MAX_POOLED_WIDTH && !Pooled().inUse), m_pScratch(nullptr)
+    {
+        if (m_pooled) {
+            PooledScratch& pooled = Pooled();
+            if (pooled.pScratch == nullptr) {
+                pooled.pScratch = secp256k1_scratch_space_create(pContext, MAX_SIZE);
+            }
+
+            pooled.inUse = true;
+            m_pScratch = pooled.pScratch;
+        } else {
+            m_pScratch = secp256k1_scratch_space_create(pContext, MAX_SIZE);
+        }
+    }
+
+    ~ScratchSpace()
+    {
+        if (m_pooled) {
+            Pooled().inUse = false;
+        } else {
+            secp256k1_scratch_space_destroy(m_pScratch);
+        }
+    }
+
+    ScratchSpace(const ScratchSpace&) = delete;
+    ScratchSpace& operator=(const ScratchSpace&) = delete;
+
+    secp256k1_scratch_space* Get() noexcept { return m_pScratch; }
+
+private:
+    struct PooledScratch
+    {
+        ~PooledScratch() { secp256k1_scratch_space_destroy(pScratch); }
+
+        secp256k1_scratch_space* pScratch = nullptr;
+        bool inUse = false;
+    };
+
+    static PooledScratch& Pooled()
+    {
+        static thread_local PooledScratch pooled;
+        return pooled;
+    }
+
+    bool m_pooled;
+    secp256k1_scratch_space* m_pScratch;
+};
@@ -128,13 +128,13 @@ void File::Write(const size_t startIndex, const std::vector<uint8_t>& bytes, con
     }
 }
 
-void File::WriteBytes(const std::unordered_map<uint64_t, uint8_t>& bytes)
+void File::WriteBytes(const std::vector<std::pair<uint64_t, std::vector<uint8_t>>>& chunks)
 {
     std::fstream file(m_path.m_path, std::ios_base::binary | std::ios_base::out | std::ios_base::in);
 
-    for (auto iter : bytes) {
-        file.seekp(iter.first);
-        file.write((const char*)&iter.second, 1);
+    for (const auto& chunk : chunks) {
+        file.seekp(chunk.first);
+        file.write((const char*)chunk.second.data(), chunk.second.size());
     }
 
     file.close();
@@ -1,13 +1,26 @@
 #include <mw/mmr/LeafSet.h>
 #include <mw/crypto/Hasher.h>
 
+#include <bitset>
+
 using namespace mmr;
 
+static constexpr uint64_t LEAVES_PER_WORD = 64;
+
+// Returns a mask of the first numLeaves (0-63) leaves of a word.
+// Example: KeepMask(10) returns 0xC0FF (byte 0 fully set, top 2 bits of byte 1).
+static uint64_t KeepMask(const uint64_t numLeaves) noexcept
+{
+    const uint64_t fullBytes = numLeaves / 8;
+    uint64_t mask = fullBytes == 0 ? 0 : (~(uint64_t)0 >> (64 - (fullBytes * 8)));
+    mask |= (uint64_t)((0xff00 >> (numLeaves % 8)) & 0xff) << (fullBytes * 8);
+    return mask;
+}
+
 void ILeafSet::Add(const LeafIndex& idx)
 {
-    uint8_t byte = GetByte(idx.Get() / 8);
-    byte |= BitToByte(idx.Get() % 8);
-    SetByte(idx.Get() / 8, byte);
+    const uint64_t wordIdx = idx.Get() / LEAVES_PER_WORD;
+    SetWord(wordIdx, GetWord(wordIdx) | LeafMask(idx));
 
     if (idx >= m_nextLeafIdx) {
         m_nextLeafIdx = idx.Next();
@@ -16,14 +29,16 @@ void ILeafSet::Add(const LeafIndex& idx)
 
 void ILeafSet::Remove(const LeafIndex& idx)
 {
-    uint8_t byte = GetByte(idx.Get() / 8);
-    byte &= (0xff ^ BitToByte(idx.Get() % 8));
-    SetByte(idx.Get() / 8, byte);
+    const uint64_t wordIdx = idx.Get() / LEAVES_PER_WORD;
+    const uint64_t word = GetWord(wordIdx);
+    if (word & LeafMask(idx)) {
+        SetWord(wordIdx, word & ~LeafMask(idx));
+    }
 }
 
 bool ILeafSet::Contains(const LeafIndex& idx) const noexcept
 {
-    return GetByte(idx.Get() / 8) & BitToByte(idx.Get() % 8);
+    return GetWord(idx.Get() / LEAVES_PER_WORD) & LeafMask(idx);
 }
 
 mw::Hash ILeafSet::Root() const
@@ -31,9 +46,11 @@ mw::Hash ILeafSet::Root() const
     uint64_t numBytes = (m_nextLeafIdx.Get() + 7) / 8;
 
     std::vector<uint8_t> bytes(numBytes);
-    for (uint64_t byte_idx = 0; byte_idx < numBytes; byte_idx++) {
-        uint8_t byte = GetByte(byte_idx);
-        bytes[byte_idx] = byte;
+    for (uint64_t word_idx = 0; (word_idx * 8) < numBytes; word_idx++) {
+        const uint64_t word = GetWord(word_idx);
+        for (uint64_t i = 0; i < 8 && (word_idx * 8) + i < numBytes; i++) {
+            bytes[(word_idx * 8) + i] = (uint8_t)(word >> (i * 8));
+        }
     }
 
     return Hashed(bytes);
@@ -45,32 +62,67 @@ void ILeafSet::Rewind(const uint64_t numLeaves, const std::vector<LeafIndex>& le
         Add(idx);
     }
 
-    for (uint64_t i = numLeaves; i < m_nextLeafIdx.Get(); i++) {
-        Remove(LeafIndex::At(i));
-    }
+    RemoveFrom(numLeaves);
 
     m_nextLeafIdx = mmr::LeafIndex::At(numLeaves);
 }
 
-// Returns a byte with the given bit (0-7) set.
-// Example: BitToByte(2) returns 32 (00100000).
-uint8_t ILeafSet::BitToByte(const uint8_t bit) const
+uint64_t ILeafSet::GetNumUnspent(const mmr::LeafIndex& endIdx) const
 {
-    return 1 << (7 - bit);
+    const uint64_t numFullWords = endIdx.Get() / LEAVES_PER_WORD;
+
+    uint64_t numUnspent = 0;
+    for (uint64_t word_idx = 0; word_idx < numFullWords; word_idx++) {
+        numUnspent += std::bitset<64>(GetWord(word_idx)).count();
+    }
+
+    if (endIdx.Get() % LEAVES_PER_WORD != 0) {
+        const uint64_t word = GetWord(numFullWords) & KeepMask(endIdx.Get() % LEAVES_PER_WORD);
+        numUnspent += std::bitset<64>(word).count();
+    }
+
+    return numUnspent;
+}
+
+// Leaf i is bit (7 - i % 8) of leafset byte i / 8, which is byte (i / 8) % 8 of its word.
+uint64_t ILeafSet::LeafMask(const LeafIndex& idx) noexcept
+{
+    const uint64_t bit = idx.Get() % LEAVES_PER_WORD;
+    return (uint64_t)(0x80 >> (bit % 8)) << ((bit / 8) * 8);
+}
+
+void ILeafSet::RemoveFrom(const uint64_t numLeaves)
+{
+    const uint64_t endWord = (m_nextLeafIdx.Get() + LEAVES_PER_WORD - 1) / LEAVES_PER_WORD;
+    for (uint64_t word_idx = numLeaves / LEAVES_PER_WORD; word_idx < endWord; word_idx++) {
+        const uint64_t firstLeaf = word_idx * LEAVES_PER_WORD;
+        const uint64_t keep = numLeaves > firstLeaf ? KeepMask(numLeaves - firstLeaf) : 0;
+
+        const uint64_t word = GetWord(word_idx);
+        if ((word & keep) != word) {
+            SetWord(word_idx, word & keep);
+        }
+    }
 }
 
 BitSet ILeafSet::ToBitSet() const
 {
     BitSet bitset(GetNextLeafIdx().Get());
 
-    mmr::LeafIndex idx = mmr::LeafIndex::At(0);
-    while (idx < GetNextLeafIdx()) {
-        if (Contains(idx)) {
-            bitset.set(idx.Get());
+    const uint64_t numLeaves = GetNextLeafIdx().Get();
+    for (uint64_t word_idx = 0; (word_idx * LEAVES_PER_WORD) < numLeaves; word_idx++) {
+        const uint64_t word = GetWord(word_idx);
+        if (word == 0) {
+            continue;
         }
 
-        ++idx;
+        for (uint64_t i = 0; i < LEAVES_PER_WORD; i++) {
+            const uint64_t leaf_idx = (word_idx * LEAVES_PER_WORD) + i;
+            if (leaf_idx < numLeaves && (word & LeafMask(LeafIndex::At(leaf_idx)))) {
+                bitset.set(leaf_idx);
+            }
+        }
     }
 
     return bitset;
-}
\ No newline at end of file
+}
@@ -30,15 +30,15 @@ FilePath LeafSet::GetPath(const FilePath& leafset_dir, const uint32_t file_index
 void LeafSet::ApplyUpdates(
     const uint32_t file_index,
     const mmr::LeafIndex& nextLeafIdx,
-    const std::unordered_map<uint64_t, uint8_t>& modifiedBytes)
+    const DirtyWords& modifiedWords)
 {
-    for (auto byte : modifiedBytes) {
-        m_modifiedBytes[byte.first + 8] = byte.second;
-    }
+    modifiedWords.ForEach([this](const uint64_t wordIdx, const uint64_t word) {
+        m_modifiedWords.Set(wordIdx, word);
+    });
 
     // In case of rewind, make sure to clear everything above the new next
-    for (size_t idx = nextLeafIdx.Get(); idx < m_nextLeafIdx.Get(); idx++) {
-        Remove(mmr::LeafIndex::At(idx));
+    if (nextLeafIdx < m_nextLeafIdx) {
+        RemoveFrom(nextLeafIdx.Get());
     }
 
     m_nextLeafIdx = nextLeafIdx;
@@ -53,20 +53,34 @@ void LeafSet::Flush(const uint32_t file_index)
     std::vector<uint8_t> nextLeafIdxBytes = m_nextLeafIdx.Serialized();
     assert(nextLeafIdxBytes.size() == 8);
 
-    for (uint8_t i = 0; i < 8; i++) {
-        m_modifiedBytes[i] = nextLeafIdxBytes[i];
-    }
+    // Coalesce runs of consecutive dirty words, so each run is a single write.
+    std::vector<std::pair<uint64_t, std::vector<uint8_t>>> chunks;
+    chunks.push_back({ 0, std::move(nextLeafIdxBytes) });
+
+    uint64_t nextWordIdx = 0;
+    m_modifiedWords.ForEach([&chunks, &nextWordIdx](const uint64_t wordIdx, const uint64_t word) {
+        if (chunks.size() == 1 || wordIdx != nextWordIdx) {
+            chunks.push_back({ 8 + (wordIdx * 8), {} });
+        }
+
+        std::vector<uint8_t>& bytes = chunks.back().second;
+        for (uint8_t i = 0; i < 8; i++) {
+            bytes.push_back((uint8_t)(word >> (i * 8)));
+        }
+
+        nextWordIdx = wordIdx + 1;
+    });
 
     FilePath new_leafset_path = GetPath(m_dir, file_index);
     m_mmap.GetFile().CopyTo(new_leafset_path);
 
     File new_leafset_file(std::move(new_leafset_path));
-    new_leafset_file.WriteBytes(m_modifiedBytes);
+    new_leafset_file.WriteBytes(chunks);
 
     m_mmap = MemMap{ new_leafset_file };
     m_mmap.Map();
 
-    m_modifiedBytes.clear();
+    m_modifiedWords.clear();
 }
 
 void LeafSet::Cleanup(const uint32_t current_file_index) const
@@ -82,25 +96,26 @@ void LeafSet::Cleanup(const uint32_t current_file_index) const
     }
 }
 
-uint8_t LeafSet::GetByte(const uint64_t byteIdx) const
+uint64_t LeafSet::GetWord(const uint64_t wordIdx) const
 {
-    // Offset by 8 bytes, since first 8 bytes in file represent the next leaf index
-    const uint64_t byteIdxWithOffset = byteIdx + 8;
-
-    auto iter = m_modifiedBytes.find(byteIdxWithOffset);
-    if (iter != m_modifiedBytes.cend())
-    {
-        return iter->second;
+    const uint64_t* pModified = m_modifiedWords.Find(wordIdx);
+    if (pModified != nullptr) {
+        return *pModified;
     }
-    else if (byteIdxWithOffset < m_mmap.size())
-    {
-        return m_mmap.ReadByte(byteIdxWithOffset);
+
+    // Offset by 8 bytes, since first 8 bytes in file represent the next leaf index.
+    // Bytes past the end of the file are unset.
+    const uint64_t offset = 8 + (wordIdx * 8);
+
+    uint64_t word = 0;
+    for (uint64_t i = 0; i < 8 && offset + i < m_mmap.size(); i++) {
+        word |= (uint64_t)m_mmap.ReadByte(offset + i) << (i * 8);
     }
 
-    return 0;
+    return word;
 }
 
-void LeafSet::SetByte(const uint64_t byteIdx, const uint8_t value)
+void LeafSet::SetWord(const uint64_t wordIdx, const uint64_t word)
 {
-    m_modifiedBytes[byteIdx + 8] = value;
-}
\ No newline at end of file
+    m_modifiedWords.Set(wordIdx, word);
+}
@@ -6,33 +6,32 @@ using namespace mmr;
 void LeafSetCache::ApplyUpdates(
     const uint32_t /*file_index*/,
     const mmr::LeafIndex& nextLeafIdx,
-    const std::unordered_map<uint64_t, uint8_t>& modifiedBytes)
+    const DirtyWords& modifiedWords)
 {
     m_nextLeafIdx = nextLeafIdx;
 
-    for (auto byte : modifiedBytes) {
-        m_modifiedBytes[byte.first] = byte.second;
-    }
+    modifiedWords.ForEach([this](const uint64_t wordIdx, const uint64_t word) {
+        m_modifiedWords.Set(wordIdx, word);
+    });
 }
 
 void LeafSetCache::Flush(const uint32_t file_index)
 {
-    m_pBacked->ApplyUpdates(file_index, m_nextLeafIdx, m_modifiedBytes);
-    m_modifiedBytes.clear();
+    m_pBacked->ApplyUpdates(file_index, m_nextLeafIdx, m_modifiedWords);
+    m_modifiedWords.clear();
 }
 
-uint8_t LeafSetCache::GetByte(const uint64_t byteIdx) const
+uint64_t LeafSetCache::GetWord(const uint64_t wordIdx) const
 {
-    auto iter = m_modifiedBytes.find(byteIdx);
-    if (iter != m_modifiedBytes.cend())
-    {
-        return iter->second;
+    const uint64_t* pModified = m_modifiedWords.Find(wordIdx);
+    if (pModified != nullptr) {
+        return *pModified;
     }
 
-    return m_pBacked->GetByte(byteIdx);
+    return m_pBacked->GetWord(wordIdx);
 }
 
-void LeafSetCache::SetByte(const uint64_t byteIdx, const uint8_t value)
+void LeafSetCache::SetWord(const uint64_t wordIdx, const uint64_t word)
 {
-    m_modifiedBytes[byteIdx] = value;
-}
\ No newline at end of file
+    m_modifiedWords.Set(wordIdx, word);
+}
@@ -2,8 +2,10 @@
 #include <mw/mmr/MMR.h>
 #include <mw/crypto/Hasher.h>
 #include <mw/util/BitUtil.h>
+#include <crypto/common.h>
 
 #include <boost/dynamic_bitset.hpp>
+#include <array>
 #include <cmath>
 
 using namespace mmr;
@@ -17,6 +19,58 @@ mw::Hash MMRUtil::CalcParentHash(const Index& index, const mw::Hash& left_hash,
         .hash();
 }
 
+std::vector<mw::Hash> MMRUtil::CalcAppendedHashes(const IMMR& mmr, const std::vector<Leaf>& leaves)
+{
+    const uint64_t first_pos = mmr.GetNumNodes();
+    const uint64_t num_nodes = LeafIndex::At(mmr.GetNumLeaves() + leaves.size()).GetPosition();
+
+    std::vector<mw::Hash> hashes(num_nodes - first_pos);
+    std::vector<Index> level;
+    level.reserve(leaves.size());
+    for (const Leaf& leaf : leaves) {
+        assert(leaf.GetLeafIndex().Get() == mmr.GetNumLeaves() + level.size());
+        hashes[leaf.GetNodeIndex().GetPosition() - first_pos] = leaf.GetHash();
+        level.push_back(leaf.GetNodeIndex());
+    }
+
+    // Serialized the same way as in CalcParentHash: position, left hash, right hash.
+    using ParentMsg = std::array<uint8_t, 8 + 32 + 32>;
+
+    while (!level.empty()) {
+        // Only right children complete a parent, and those parents are new too
+        std::vector<Index> parents;
+        for (const Index& node : level) {
+            const Index parent = node.GetParent();
+            if (parent.GetPosition() < num_nodes && (parents.empty() || parents.back() != parent)) {
+                parents.push_back(parent);
+            }
+        }
+
+        std::vector<ParentMsg> messages(parents.size());
+        std::vector<const uint8_t*> message_ptrs;
+        message_ptrs.reserve(parents.size());
+        for (size_t i = 0; i < parents.size(); i++) {
+            const Index left = parents[i].GetLeftChild();
+            const mw::Hash left_hash = left.GetPosition() < first_pos ? mmr.GetHash(left) : hashes[left.GetPosition() - first_pos];
+            const mw::Hash& right_hash = hashes[parents[i].GetRightChild().GetPosition() - first_pos];
+
+            WriteLE64(messages[i].data(), parents[i].GetPosition());
+            memcpy(messages[i].data() + 8, left_hash.data(), 32);
+            memcpy(messages[i].data() + 40, right_hash.data(), 32);
+            message_ptrs.push_back(messages[i].data());
+        }
+
+        std::vector<mw::Hash> parent_hashes = HashedMany(message_ptrs, sizeof(ParentMsg));
+        for (size_t i = 0; i < parents.size(); i++) {
+            hashes[parents[i].GetPosition() - first_pos] = std::move(parent_hashes[i]);
+        }
+
+        level = std::move(parents);
+    }
+
+    return hashes;
+}
+
 std::vector<mmr::Index> MMRUtil::CalcPeakIndices(const uint64_t num_nodes)
 {
     if (num_nodes == 0) {
@@ -19,6 +19,13 @@ LeafIndex MemMMR::AddLeaf(const Leaf& leaf)
     return leaf.GetLeafIndex();
 }
 
+void MemMMR::AddLeaves(const std::vector<Leaf>& leaves)
+{
+    std::vector<mw::Hash> hashes = MMRUtil::CalcAppendedHashes(*this, leaves);
+    m_leaves.insert(m_leaves.end(), leaves.cbegin(), leaves.cend());
+    m_hashes.insert(m_hashes.end(), std::make_move_iterator(hashes.begin()), std::make_move_iterator(hashes.end()));
+}
+
 Leaf MemMMR::GetLeaf(const LeafIndex& leafIdx) const
 {
     assert(leafIdx.Get() < m_leaves.size());
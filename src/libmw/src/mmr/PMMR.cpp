@@ -50,6 +50,19 @@ LeafIndex PMMR::AddLeaf(const mmr::Leaf& leaf)
     return leaf.GetLeafIndex();
 }
 
+void PMMR::AddLeaves(const std::vector<Leaf>& leaves)
+{
+    std::vector<mw::Hash> hashes = MMRUtil::CalcAppendedHashes(*this, leaves);
+    for (const Leaf& leaf : leaves) {
+        m_leafMap[leaf.GetLeafIndex()] = m_leaves.size();
+        m_leaves.push_back(leaf);
+    }
+
+    for (const mw::Hash& hash : hashes) {
+        m_pHashFile->Append(hash.vec());
+    }
+}
+
 Leaf PMMR::GetLeaf(const LeafIndex& idx) const
 {
     auto it = m_leafMap.find(idx);
@@ -76,6 +89,11 @@ mw::Hash PMMR::GetHash(const Index& idx) const
     return mw::Hash(m_pHashFile->Read(pos * mw::Hash::size(), mw::Hash::size()));
 }
 
+bool PMMR::IsCompacted(const LeafIndex& leafIdx) const noexcept
+{
+    return m_pPruneList && m_pPruneList->IsCompacted(leafIdx.GetNodeIndex());
+}
+
 uint64_t PMMR::GetNumLeaves() const noexcept
 {
     uint64_t num_hashes = (m_pHashFile->GetSize() / mw::Hash::size());
@@ -113,9 +131,7 @@ void PMMR::BatchWrite(
     LOG_TRACE_F("Writing batch {} with first leaf {}", file_index, firstLeafIdx.Get());
 
     Rewind(firstLeafIdx.Get());
-    for (const Leaf& leaf : leaves) {
-        AddLeaf(leaf);
-    }
+    AddLeaves(leaves);
 
     m_pHashFile->Commit(GetPath(m_dir, m_dbPrefix, file_index));
 
@@ -138,4 +154,63 @@ void PMMR::Cleanup(const uint32_t current_file_index) const
             break;
         }
     }
-}
\ No newline at end of file
+}
+void PMMR::Compact(const uint32_t file_index, const BitSet& compacted, const std::unique_ptr<mw::DBBatch>& pBatch)
+{
+    assert(m_leaves.empty());
+
+    const uint64_t num_nodes = GetNumNodes();
+    LOG_DEBUG_F("Compacting {} nodes into file {}", num_nodes, file_index);
+
+    FilePath new_hash_path = GetPath(m_dir, m_dbPrefix, file_index);
+    if (new_hash_path.Exists()) {
+        new_hash_path.Remove();
+    }
+
+    File new_hash_file(new_hash_path);
+    new_hash_file.Create();
+
+    // Copy the hashes of the remaining nodes, reading the current file sequentially,
+    // since PruneList::GetShift would be linear in the node position.
+    std::vector<uint8_t> buffer;
+    std::vector<mmr::LeafIndex> compacted_leaves;
+    uint64_t file_pos = 0;
+    for (uint64_t pos = 0; pos < num_nodes; pos++) {
+        const Index idx = Index::At(pos);
+        if (m_pPruneList && m_pPruneList->IsCompacted(idx)) {
+            assert(compacted.test(pos));
+            continue;
+        }
+
+        if (compacted.test(pos)) {
+            if (idx.IsLeaf()) {
+                compacted_leaves.push_back(LeafIndex::At(idx.GetLeafIndex()));
+            }
+        } else {
+            std::vector<uint8_t> hash = m_pHashFile->Read(file_pos * mw::Hash::size(), mw::Hash::size());
+            buffer.insert(buffer.end(), hash.cbegin(), hash.cend());
+            if (buffer.size() >= (1 << 20)) {
+                new_hash_file.Write(buffer);
+                buffer.clear();
+            }
+        }
+
+        ++file_pos;
+    }
+
+    new_hash_file.Write(buffer);
+
+    FilePath new_prune_path = PruneList::GetPath(m_dir, file_index);
+    if (new_prune_path.Exists()) {
+        new_prune_path.Remove();
+    }
+
+    PruneList::Ptr pPruneList = PruneList::Open(m_dir, file_index);
+    pPruneList->Commit(file_index, compacted);
+
+    LeafDB(m_dbPrefix, m_pDatabase.get(), pBatch.get())
+        .Remove(compacted_leaves);
+
+    m_pHashFile = AppendOnlyFile::Load(new_hash_path);
+    m_pPruneList = pPruneList;
+}
@@ -22,6 +22,13 @@ LeafIndex PMMRCache::AddLeaf(const Leaf& leaf)
     return leaf.GetLeafIndex();
 }
 
+void PMMRCache::AddLeaves(const std::vector<Leaf>& leaves)
+{
+    std::vector<mw::Hash> hashes = MMRUtil::CalcAppendedHashes(*this, leaves);
+    m_nodes.insert(m_nodes.end(), std::make_move_iterator(hashes.begin()), std::make_move_iterator(hashes.end()));
+    m_leaves.insert(m_leaves.end(), leaves.cbegin(), leaves.cend());
+}
+
 Leaf PMMRCache::GetLeaf(const LeafIndex& leafIdx) const
 {
     if (leafIdx < m_firstLeaf) {
@@ -56,6 +63,11 @@ mw::Hash PMMRCache::GetHash(const Index& idx) const
     }
 }
 
+bool PMMRCache::IsCompacted(const LeafIndex& leafIdx) const noexcept
+{
+    return leafIdx < m_firstLeaf && m_pBase->IsCompacted(leafIdx);
+}
+
 void PMMRCache::Rewind(const uint64_t numLeaves)
 {
     LOG_TRACE_F("Rewinding to {}", numLeaves);
@@ -90,9 +102,7 @@ void PMMRCache::BatchWrite(
 {
     LOG_TRACE_F("Writing batch {}", firstLeafIdx.Get());
     Rewind(firstLeafIdx.Get());
-    for (const Leaf& leaf : leaves) {
-        Add(leaf.vec());
-    }
+    AddLeaves(leaves);
 }
 
 void PMMRCache::Flush(const uint32_t file_index, const std::unique_ptr<mw::DBBatch>& pBatch)
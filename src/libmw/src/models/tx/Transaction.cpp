@@ -55,4 +55,7 @@ void Transaction::Validate() const
 
     KernelSumValidator::ValidateForTx(*this);
     StealthSumValidator::Validate(m_stealthOffset, m_body);
+
+    // Blocks including this transaction can skip its signatures and range proofs
+    m_body.MarkVerified();
 }
\ No newline at end of file
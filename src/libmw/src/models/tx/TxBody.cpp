@@ -2,10 +2,30 @@
 #include <mw/exceptions/ValidationException.h>
 #include <mw/consensus/Params.h>
 #include <mw/consensus/Weight.h>
+#include <mw/crypto/VerificationCache.h>
 
 #include <unordered_set>
 #include <numeric>
 
+static VerificationCache CACHE('T');
+
+// Kernels, inputs and outputs are cached by their hashes, which commit
+// to their signatures and range proofs. The type byte keeps an element
+// of one type from vouching for another.
+static uint256 CacheEntry(const uint8_t type, const mw::Hash& hash)
+{
+    uint256 entry;
+    CACHE.Hasher()
+        .Write(&type, 1)
+        .Write(hash.data(), hash.size())
+        .Finalize(entry.begin());
+    return entry;
+}
+
+static uint256 CacheEntry(const Kernel& kernel) { return CacheEntry('K', kernel.GetKernelID()); }
+static uint256 CacheEntry(const Input& input) { return CacheEntry('I', input.GetHash()); }
+static uint256 CacheEntry(const Output& output) { return CacheEntry('O', output.GetOutputID()); }
+
 std::vector<PegInCoin> TxBody::GetPegIns() const noexcept
 {
     std::vector<PegInCoin> pegins;
@@ -98,23 +118,28 @@ void TxBody::Validate() const
     }
 
     //
-    // Verify all signatures
+    // Verify all signatures, except for elements verified before
     //
     std::vector<SignedMessage> signatures;
-    std::transform(
-        m_kernels.cbegin(), m_kernels.cend(), std::back_inserter(signatures),
-        [](const Kernel& kernel) { return kernel.BuildSignedMsg(); }
-    );
+    for (const Kernel& kernel : m_kernels) {
+        if (!CACHE.Contains(CacheEntry(kernel))) {
+            signatures.push_back(kernel.BuildSignedMsg());
+        }
+    }
 
-    std::transform(
-        m_inputs.cbegin(), m_inputs.cend(), std::back_inserter(signatures),
-        [](const Input& input) { return input.BuildSignedMsg(); }
-    );
+    for (const Input& input : m_inputs) {
+        if (!CACHE.Contains(CacheEntry(input))) {
+            signatures.push_back(input.BuildSignedMsg());
+        }
+    }
 
-    std::transform(
-        m_outputs.cbegin(), m_outputs.cend(), std::back_inserter(signatures),
-        [](const Output& output) { return output.BuildSignedMsg(); }
-    );
+    std::vector<const Output*> unverified_outputs;
+    for (const Output& output : m_outputs) {
+        if (!CACHE.Contains(CacheEntry(output))) {
+            signatures.push_back(output.BuildSignedMsg());
+            unverified_outputs.push_back(&output);
+        }
+    }
 
     if (!Schnorr::BatchVerify(signatures)) {
         ThrowValidation(EConsensusError::INVALID_SIG);
@@ -125,10 +150,26 @@ void TxBody::Validate() const
     //
     std::vector<ProofData> rangeProofs;
     std::transform(
-        m_outputs.cbegin(), m_outputs.cend(), std::back_inserter(rangeProofs),
-        [](const Output& output) { return output.BuildProofData(); }
+        unverified_outputs.cbegin(), unverified_outputs.cend(), std::back_inserter(rangeProofs),
+        [](const Output* pOutput) { return pOutput->BuildProofData(); }
     );
     if (!Bulletproofs::BatchVerify(rangeProofs)) {
         ThrowValidation(EConsensusError::BULLETPROOF);
     }
+}
+
+void TxBody::MarkVerified() const
+{
+    std::vector<uint256> entries;
+    entries.reserve(m_kernels.size() + m_inputs.size() + m_outputs.size());
+    std::transform(m_kernels.cbegin(), m_kernels.cend(), std::back_inserter(entries), [](const Kernel& kernel) { return CacheEntry(kernel); });
+    std::transform(m_inputs.cbegin(), m_inputs.cend(), std::back_inserter(entries), [](const Input& input) { return CacheEntry(input); });
+    std::transform(m_outputs.cbegin(), m_outputs.cend(), std::back_inserter(entries), [](const Output& output) { return CacheEntry(output); });
+
+    CACHE.Insert(entries);
+}
+
+size_t TxBody::SetCacheSize(const size_t bytes)
+{
+    return CACHE.SetupBytes(bytes);
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <mw/node/CoinsView.h>
+#include <mw/exceptions/NotFoundException.h>
 #include <mw/exceptions/ValidationException.h>
 #include <mw/consensus/Aggregation.h>
 #include <mw/consensus/KernelSumValidator.h>
@@ -44,14 +45,9 @@ mw::BlockUndo::CPtr CoinsViewCache::ApplyBlock(const mw::Block::CPtr& pBlock)
     BlindingFactor prev_offset = pPreviousHeader != nullptr ? pPreviousHeader->GetKernelOffset() : BlindingFactor();
     KernelSumValidator::ValidateForBlock(pBlock->GetTxBody(), pBlock->GetKernelOffset(), prev_offset);
 
-    std::vector<mw::Hash> coinsAdded;
-    std::for_each(
-        pBlock->GetOutputs().cbegin(), pBlock->GetOutputs().cend(),
-        [this, &pBlock, &coinsAdded](const Output& output) {
-            AddUTXO(pBlock->GetHeight(), output);
-            coinsAdded.push_back(output.GetOutputID());
-        }
-    );
+    AddUTXOs(pBlock->GetHeight(), pBlock->GetOutputs());
+
+    std::vector<mw::Hash> coinsAdded = pBlock->GetTxBody().GetOutputIDs();
 
     std::vector<UTXO> coinsSpent;
     std::for_each(
@@ -77,12 +73,7 @@ static const uint32_t MEMPOOL_HEIGHT = 0x7FFFFFFF;
 
 void CoinsViewCache::AddTx(const mw::Transaction::CPtr& pTx)
 {
-    std::for_each(
-        pTx->GetOutputs().cbegin(), pTx->GetOutputs().cend(),
-        [this](const Output& output) {
-            AddUTXO(MEMPOOL_HEIGHT, output);
-        }
-    );
+    AddUTXOs(MEMPOOL_HEIGHT, pTx->GetOutputs());
 
     std::for_each(
         pTx->GetInputs().cbegin(), pTx->GetInputs().cend(),
@@ -96,6 +87,13 @@ void CoinsViewCache::UndoBlock(const mw::BlockUndo::CPtr& pUndo)
 {
     assert(pUndo != nullptr);
 
+    // Spent coins below the compaction horizon no longer have their hashes in the MMR files.
+    for (const UTXO& coinToAdd : pUndo->GetCoinsSpent()) {
+        if (m_pOutputPMMR->IsCompacted(coinToAdd.GetLeafIndex())) {
+            ThrowNotFound_F("Can't restore compacted leaf {}", coinToAdd.GetLeafIndex().Get());
+        }
+    }
+
     std::vector<mmr::LeafIndex> leavesToAdd;
     for (const UTXO& coinToAdd : pUndo->GetCoinsSpent()) {
         leavesToAdd.push_back(coinToAdd.GetLeafIndex());
@@ -134,15 +132,9 @@ mw::Block::Ptr CoinsViewCache::BuildNextBlock(const uint64_t height, const std::
     auto pTransaction = Aggregation::Aggregate(transactions);
 
     MemMMR::Ptr pKernelMMR = std::make_shared<MemMMR>();
-    std::for_each(
-        pTransaction->GetKernels().cbegin(), pTransaction->GetKernels().cend(),
-        [&pKernelMMR](const Kernel& kernel) { pKernelMMR->Add(kernel); }
-    );
+    pKernelMMR->AddAll(pTransaction->GetKernels());
 
-    std::for_each(
-        pTransaction->GetOutputs().cbegin(), pTransaction->GetOutputs().cend(),
-        [this, height](const Output& output) { AddUTXO(height, output); }
-    );
+    AddUTXOs(height, pTransaction->GetOutputs());
 
     std::for_each(
         pTransaction->GetInputs().cbegin(), pTransaction->GetInputs().cend(),
@@ -200,19 +192,29 @@ bool CoinsViewCache::HasSpendInCache(const mw::Hash& output_id) const noexcept
     return false;
 }
 
-void CoinsViewCache::AddUTXO(const uint64_t header_height, const Output& output)
+void CoinsViewCache::AddUTXOs(const uint64_t header_height, const std::vector<Output>& outputs)
 {
-    UTXO::CPtr pUTXO = GetUTXO(output.GetOutputID());
-    if (pUTXO != nullptr) {// && m_pLeafSet->Contains(pUTXO->GetLeafIndex())) {
-        ThrowValidation(EConsensusError::DUPLICATES);
-    }
+    std::vector<mmr::Leaf> leaves;
+    leaves.reserve(outputs.size());
+
+    mmr::LeafIndex leafIdx = m_pOutputPMMR->GetNextLeafIdx();
+    for (const Output& output : outputs) {
+        UTXO::CPtr pUTXO = GetUTXO(output.GetOutputID());
+        if (pUTXO != nullptr) {// && m_pLeafSet->Contains(pUTXO->GetLeafIndex())) {
+            ThrowValidation(EConsensusError::DUPLICATES);
+        }
 
-    mmr::LeafIndex leafIdx = m_pOutputPMMR->Add(output.GetOutputID());
-    m_pLeafSet->Add(leafIdx);
+        leaves.push_back(mmr::Leaf::Create(leafIdx, output.GetOutputID().vec()));
+        m_pLeafSet->Add(leafIdx);
 
-    pUTXO = std::make_shared<UTXO>(header_height, std::move(leafIdx), output);
+        pUTXO = std::make_shared<UTXO>(header_height, leafIdx, output);
+
+        m_pUpdates->AddUTXO(pUTXO);
+        leafIdx = leafIdx.Next();
+    }
 
-    m_pUpdates->AddUTXO(pUTXO);
+    // The outputs' leaves are appended together, so the MMR's parent hashes are calculated in batches
+    m_pOutputPMMR->AddLeaves(leaves);
 }
 
 UTXO CoinsViewCache::SpendUTXO(const mw::Hash& output_id)
@@ -3,7 +3,9 @@
 #include <mw/db/CoinDB.h>
 #include <mw/db/MMRInfoDB.h>
 #include <mw/exceptions/ValidationException.h>
+#include <mw/mmr/MMRUtil.h>
 #include <mw/mmr/PruneList.h>
+#include <mw/common/Logger.h>
 
 #include "CoinActions.h"
 
@@ -21,7 +23,7 @@ CoinsViewDB::Ptr CoinsViewDB::Open(
     auto pLeafSet = LeafSet::Open(datadir, file_index);
     auto pPruneList = PruneList::Open(datadir, compact_index);
     auto pOutputMMR = PMMR::Open('O', datadir, file_index, pDBWrapper, pPruneList);
-    auto pView = new CoinsViewDB(pBestHeader, pDBWrapper, pLeafSet, pOutputMMR);
+    auto pView = new CoinsViewDB(datadir, pBestHeader, pDBWrapper, pLeafSet, pOutputMMR);
 
     return std::shared_ptr<CoinsViewDB>(pView);
 }
@@ -94,4 +96,63 @@ void CoinsViewDB::Compact() const
         m_pLeafSet->Cleanup(current_mmr_info->index);
         m_pOutputPMMR->Cleanup(current_mmr_info->index);
     }
-}
\ No newline at end of file
+}
+bool CoinsViewDB::CompactMMR(const mw::Header::CPtr& pHorizonHeader, const std::vector<mmr::LeafIndex>& spent_since_horizon)
+{
+    assert(pHorizonHeader != nullptr);
+    const uint64_t num_leaves = pHorizonHeader->GetNumTXOs();
+
+    // Leaves spent above the horizon are restored when disconnecting those blocks, so they're treated as unspent.
+    BitSet unspent(num_leaves);
+    for (uint64_t i = 0; i < num_leaves; i++) {
+        unspent.set(i, m_pLeafSet->Contains(mmr::LeafIndex::At(i)));
+    }
+
+    for (const mmr::LeafIndex& leaf_idx : spent_since_horizon) {
+        if (leaf_idx.Get() < num_leaves) {
+            unspent.set(leaf_idx.Get());
+        }
+    }
+
+    BitSet compacted = MMRUtil::BuildCompactBitSet(num_leaves, unspent);
+
+    // Rewriting the hash file is only worthwhile once a meaningful part of it can be dropped.
+    const PruneList::CPtr& pPruneList = m_pOutputPMMR->GetPruneList();
+    const uint64_t prev_compacted = pPruneList ? pPruneList->GetTotalShift() : 0;
+    const uint64_t num_hashes = m_pOutputPMMR->GetNumNodes() - prev_compacted;
+    if (compacted.count() <= prev_compacted || (compacted.count() - prev_compacted) < (num_hashes / 16)) {
+        return false;
+    }
+
+    LOG_INFO_F("Compacting output MMR to header {}", pHorizonHeader->GetHash());
+
+    auto pBatch = GetDatabase()->CreateBatch();
+
+    MMRInfo mmr_info;
+    auto current_mmr_info = MMRInfoDB(GetDatabase().get(), pBatch.get()).GetLatest();
+    if (current_mmr_info) {
+        mmr_info = *current_mmr_info;
+    }
+
+    const uint32_t prev_compact_index = mmr_info.compact_index;
+
+    // The new files get their own index, and are only referenced once the batch is committed,
+    // so the old files remain usable if the node shuts down before that.
+    ++mmr_info.index;
+    m_pLeafSet->Flush(mmr_info.index);
+    m_pOutputPMMR->Compact(mmr_info.index, compacted, pBatch);
+
+    mmr_info.compact_index = mmr_info.index;
+    mmr_info.compacted = pHorizonHeader->GetHash();
+    MMRInfoDB(GetDatabase().get(), pBatch.get())
+        .Save(mmr_info);
+    pBatch->Commit();
+
+    FilePath prev_prune_list = PruneList::GetPath(m_datadir, prev_compact_index);
+    if (prev_prune_list.Exists()) {
+        prev_prune_list.Remove();
+    }
+
+    Compact();
+    return true;
+}
@@ -2,11 +2,20 @@
 #include <mw/crypto/Hasher.h>
 #include <mw/crypto/SecretKeys.h>
 #include <mw/models/tx/OutputMask.h>
+#include <mw/util/ParallelUtil.h>
 #include <wallet/scriptpubkeyman.h>
 #include <key_io.h>
 
 MW_NAMESPACE
 
+// Fewer outputs than this aren't worth a thread of their own
+static constexpr size_t MIN_OUTPUTS_PER_THREAD = 16;
+
+static bool MatchesViewTag(const Output& output, const PublicKey& shared_secret)
+{
+    return Hashed(EHashTag::TAG, shared_secret)[0] == output.GetViewTag();
+}
+
 bool Keychain::RewindOutput(const Output& output, mw::Coin& coin) const
 {
     if (!output.HasStandardFields()) {
@@ -15,21 +24,21 @@ bool Keychain::RewindOutput(const Output& output, mw::Coin& coin) const
 
     assert(!GetScanSecret().IsNull());
     PublicKey shared_secret = output.Ke().Mul(GetScanSecret());
-    uint8_t view_tag = Hashed(EHashTag::TAG, shared_secret)[0];
-    if (view_tag != output.GetViewTag()) {
+    if (!MatchesViewTag(output, shared_secret)) {
         return false;
     }
 
     SecretKey t = Hashed(EHashTag::DERIVE, shared_secret);
     PublicKey B_i = output.Ko().Div(Hashed(EHashTag::OUT_KEY, t));
 
-    // Check if B_i belongs to wallet
-    StealthAddress address(B_i.Mul(m_scanSecret), B_i);
-    auto pMetadata = m_spk_man.GetMetadata(address);
-    if (!pMetadata) {
+    // Check if B_i belongs to wallet before deriving the rest of its address
+    boost::optional<uint32_t> address_index = m_spk_man.GetMWEBAddressIndex(B_i.GetID());
+    if (!address_index) {
         return false;
     }
 
+    StealthAddress address(B_i.Mul(m_scanSecret), B_i);
+
     // Calc blinding factor and unmask nonce and amount.
     OutputMask mask = OutputMask::FromShared(t);
     uint64_t value = mask.MaskValue(output.GetMaskedValue());
@@ -50,9 +59,7 @@ bool Keychain::RewindOutput(const Output& output, mw::Coin& coin) const
         return false;
     }
 
-    // v0.21.2 incorrectly generated MWEB keys from the pre-split keypool for upgraded wallets.
-    // These keys will not have an mweb_index, so we set the address_index as CUSTOM_KEY.
-    coin.address_index = pMetadata->mweb_index.get_value_or(CUSTOM_KEY);
+    coin.address_index = *address_index;
     coin.blind = boost::make_optional(mask.GetRawBlind());
     coin.amount = value;
     coin.output_id = output.GetOutputID();
@@ -63,6 +70,35 @@ bool Keychain::RewindOutput(const Output& output, mw::Coin& coin) const
     return true;
 }
 
+std::vector<size_t> Keychain::ScanOutputs(const std::vector<Output>& outputs) const
+{
+    assert(!GetScanSecret().IsNull());
+
+    // Each chunk only writes its own range of flags
+    std::vector<uint8_t> matches(outputs.size(), 0);
+    ParallelUtil::ForEachChunk(
+        outputs.size(),
+        MIN_OUTPUTS_PER_THREAD,
+        [this, &outputs, &matches](const size_t begin, const size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const Output& output = outputs[i];
+                matches[i] = output.HasStandardFields() && MatchesViewTag(output, output.Ke().Mul(GetScanSecret()));
+            }
+
+            return true;
+        }
+    );
+
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < matches.size(); i++) {
+        if (matches[i]) {
+            indices.push_back(i);
+        }
+    }
+
+    return indices;
+}
+
 boost::optional<SecretKey> Keychain::CalculateOutputKey(const mw::Coin& coin) const
 {
     // If we already calculated the spend key, there's no need to calculate it again.
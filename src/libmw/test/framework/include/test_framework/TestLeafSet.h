@@ -3,6 +3,8 @@
 #include <mw/mmr/LeafSet.h>
 #include <mw/models/crypto/Commitment.h>
 
+#include <unordered_map>
+
 class TestLeafSet
 {
 public:
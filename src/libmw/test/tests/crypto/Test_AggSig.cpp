@@ -5,6 +5,7 @@
 #include <mw/crypto/MuSig.h>
 #include <mw/crypto/PublicKeys.h>
 #include <mw/crypto/Schnorr.h>
+#include <mw/util/ParallelUtil.h>
 
 #include <test_framework/TestMWEB.h>
 
@@ -94,4 +95,24 @@ BOOST_AUTO_TEST_CASE(SingleSchnorrSig)
     BOOST_REQUIRE(valid == true);
 }
 
+BOOST_AUTO_TEST_CASE(BatchVerifyParallel)
+{
+    // Enough signatures to be split across all threads
+    std::vector<SignedMessage> signatures;
+    for (size_t i = 0; i < 150; i++) {
+        signatures.push_back(Schnorr::SignMessage(SecretKey::Random(), SecretKey::Random().GetBigInt()));
+    }
+
+    ParallelUtil::SetThreads(4);
+
+    // A signature over a different message must fail the batch
+    std::vector<SignedMessage> invalid = signatures;
+    invalid[120] = SignedMessage(SecretKey::Random().GetBigInt(), invalid[120].GetPublicKey(), invalid[120].GetSignature());
+    BOOST_CHECK(!Schnorr::BatchVerify(invalid));
+
+    BOOST_CHECK(Schnorr::BatchVerify(signatures));
+
+    ParallelUtil::SetThreads(1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <mw/crypto/Bulletproofs.h>
+#include <mw/util/ParallelUtil.h>
 
 #include <test_framework/TestMWEB.h>
 
@@ -48,4 +49,63 @@ BOOST_AUTO_TEST_CASE(RangeProofs)
     BOOST_REQUIRE(Bulletproofs::BatchVerify(rangeProofs));
 }
 
+BOOST_AUTO_TEST_CASE(BatchVerifyParallel)
+{
+    // Enough proofs to be split across all threads
+    std::vector<ProofData> rangeProofs;
+    for (uint64_t value = 0; value < 20; value++) {
+        BlindingFactor blind = BlindingFactor::Random();
+        std::vector<uint8_t> extraData = secret_key_t<32>::Random().vec();
+        RangeProof::CPtr pRangeProof = Bulletproofs::Generate(
+            value,
+            SecretKey(blind.vec()),
+            SecretKey::Random(),
+            SecretKey::Random(),
+            ProofMessage(secret_key_t<20>::Random().GetBigInt()),
+            extraData
+        );
+        rangeProofs.push_back(ProofData{ Commitment::Blinded(blind, value), pRangeProof, extraData });
+    }
+
+    ParallelUtil::SetThreads(4);
+
+    // A proof with the wrong extra data must fail the batch, whichever chunk it lands in
+    std::vector<ProofData> invalidProofs = rangeProofs;
+    invalidProofs[17].extraData = secret_key_t<32>::Random().vec();
+    BOOST_CHECK(!Bulletproofs::BatchVerify(invalidProofs));
+
+    BOOST_CHECK(Bulletproofs::BatchVerify(rangeProofs));
+
+    ParallelUtil::SetThreads(1);
+}
+
+BOOST_AUTO_TEST_CASE(CachedProofs)
+{
+    BlindingFactor blind = BlindingFactor::Random();
+    Commitment commit = Commitment::Blinded(blind, 50);
+    std::vector<uint8_t> extraData = secret_key_t<32>::Random().vec();
+    RangeProof::CPtr pRangeProof = Bulletproofs::Generate(
+        50,
+        SecretKey(blind.vec()),
+        SecretKey::Random(),
+        SecretKey::Random(),
+        ProofMessage(secret_key_t<20>::Random().GetBigInt()),
+        extraData
+    );
+
+    // Verify twice, the second time from the cache
+    const std::vector<ProofData> proofs{ ProofData{ commit, pRangeProof, extraData } };
+    BOOST_CHECK(Bulletproofs::BatchVerify(proofs));
+    BOOST_CHECK(Bulletproofs::BatchVerify(proofs));
+
+    // A cached proof for the same commitment doesn't vouch for different extra data
+    const std::vector<ProofData> tampered{ ProofData{ commit, pRangeProof, secret_key_t<32>::Random().vec() } };
+    BOOST_CHECK(!Bulletproofs::BatchVerify(tampered));
+
+    // An emptied cache still verifies
+    Bulletproofs::SetCacheSize(0);
+    BOOST_CHECK(Bulletproofs::BatchVerify(proofs));
+    BOOST_CHECK(!Bulletproofs::BatchVerify(tampered));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
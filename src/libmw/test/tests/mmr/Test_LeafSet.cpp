@@ -58,4 +58,62 @@ BOOST_AUTO_TEST_CASE(LeafSetTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(LeafSetWords)
+{
+    {
+        LeafSet::Ptr pLeafset = LeafSet::Open(GetDataDir(), 0);
+
+        // Spread leaves across several words, including both edges of a word
+        std::vector<uint64_t> leaves{ 0, 7, 8, 63, 64, 65, 127, 128, 200, 511, 512, 1000 };
+        for (uint64_t leaf : leaves) {
+            pLeafset->Add(mmr::LeafIndex::At(leaf));
+        }
+
+        BOOST_REQUIRE(pLeafset->GetNextLeafIdx().Get() == 1001);
+        BOOST_REQUIRE(pLeafset->GetNumUnspent() == leaves.size());
+        BOOST_REQUIRE(pLeafset->GetNumUnspent(mmr::LeafIndex::At(0)) == 0);
+        BOOST_REQUIRE(pLeafset->GetNumUnspent(mmr::LeafIndex::At(8)) == 2);
+        BOOST_REQUIRE(pLeafset->GetNumUnspent(mmr::LeafIndex::At(64)) == 4);
+        BOOST_REQUIRE(pLeafset->GetNumUnspent(mmr::LeafIndex::At(66)) == 6);
+        BOOST_REQUIRE(pLeafset->GetNumUnspent(mmr::LeafIndex::At(201)) == 9);
+
+        BitSet bitset = pLeafset->ToBitSet();
+        BOOST_REQUIRE(bitset.size() == 1001);
+        BOOST_REQUIRE(bitset.count() == leaves.size());
+        for (uint64_t leaf : leaves) {
+            BOOST_REQUIRE(bitset.test(leaf));
+            BOOST_REQUIRE(pLeafset->Contains(mmr::LeafIndex::At(leaf)));
+        }
+
+        BOOST_REQUIRE(pLeafset->Root() == Hashed(bitset.bytes()));
+
+        pLeafset->Remove(mmr::LeafIndex::At(63));
+        BOOST_REQUIRE(!pLeafset->Contains(mmr::LeafIndex::At(63)));
+        BOOST_REQUIRE(pLeafset->GetNumUnspent() == leaves.size() - 1);
+
+        pLeafset->Flush(1);
+        BOOST_REQUIRE(pLeafset->GetNumUnspent() == leaves.size() - 1);
+        BOOST_REQUIRE(pLeafset->Root() == Hashed(pLeafset->ToBitSet().bytes()));
+
+        // Rewind into the middle of a word
+        pLeafset->Rewind(66, { mmr::LeafIndex::At(63) });
+        BOOST_REQUIRE(pLeafset->GetNextLeafIdx().Get() == 66);
+        BOOST_REQUIRE(pLeafset->GetNumUnspent() == 6);
+        BOOST_REQUIRE(!pLeafset->Contains(mmr::LeafIndex::At(127)));
+        BOOST_REQUIRE(pLeafset->Root() == Hashed(pLeafset->ToBitSet().bytes()));
+
+        pLeafset->Flush(2);
+    }
+
+    {
+        // Reload from disk and validate
+        LeafSet::Ptr pLeafset = LeafSet::Open(GetDataDir(), 2);
+        BOOST_REQUIRE(pLeafset->GetNextLeafIdx().Get() == 66);
+        BOOST_REQUIRE(pLeafset->GetNumUnspent() == 6);
+        BOOST_REQUIRE(pLeafset->Contains(mmr::LeafIndex::At(65)));
+        BOOST_REQUIRE(!pLeafset->Contains(mmr::LeafIndex::At(1000)));
+        BOOST_REQUIRE(pLeafset->Root() == Hashed({ 0b10000001, 0b10000000, 0, 0, 0, 0, 0, 0b00000001, 0b11000000 }));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
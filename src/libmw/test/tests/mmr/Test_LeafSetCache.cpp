@@ -56,4 +56,29 @@ BOOST_AUTO_TEST_CASE(LeafSetCacheTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(LeafSetCacheRewind)
+{
+    LeafSet::Ptr pLeafset = LeafSet::Open(GetDataDir(), 0);
+    for (uint64_t i = 0; i < 300; i += 3) {
+        pLeafset->Add(mmr::LeafIndex::At(i));
+    }
+    pLeafset->Flush(1);
+    BOOST_REQUIRE(pLeafset->GetNumUnspent() == 100);
+
+    // Spend a few leaves and rewind past others through the cache
+    LeafSetCache::Ptr pCache = std::make_shared<LeafSetCache>(pLeafset);
+    pCache->Remove(mmr::LeafIndex::At(0));
+    pCache->Remove(mmr::LeafIndex::At(150));
+    pCache->Rewind(200, {});
+    BOOST_REQUIRE(pCache->GetNextLeafIdx().Get() == 200);
+    BOOST_REQUIRE(pCache->GetNumUnspent() == 65);
+    BOOST_REQUIRE(pLeafset->GetNumUnspent() == 100);
+
+    pCache->Flush(2);
+    BOOST_REQUIRE(pLeafset->GetNextLeafIdx().Get() == 200);
+    BOOST_REQUIRE(pLeafset->GetNumUnspent() == 65);
+    BOOST_REQUIRE(pLeafset->Root() == pCache->Root());
+    BOOST_REQUIRE(!pLeafset->Contains(mmr::LeafIndex::At(201)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -2,7 +2,9 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <mw/file/File.h>
 #include <mw/mmr/MMR.h>
+#include <mw/mmr/MMRUtil.h>
 
 #include <test_framework/TestMWEB.h>
 
@@ -94,4 +96,109 @@ BOOST_AUTO_TEST_CASE(PMMRCacheTest)
     cache.Flush(1, nullptr);
 }
 
+BOOST_AUTO_TEST_CASE(AddLeavesBatched)
+{
+    PMMR::Ptr pmmr = PMMR::Open(
+        'O',
+        GetDataDir() / "mmr",
+        0,
+        GetDB(),
+        nullptr
+    );
+
+    PMMRCache cache(pmmr);
+    MemMMR mem;
+    MemMMR expected;
+
+    // Batches of varying sizes must build the same MMR as adding one leaf at a time
+    uint8_t next = 0;
+    uint32_t file_index = 1;
+    for (const uint8_t batch_size : { 1, 2, 5, 8, 13, 0, 31, 40 }) {
+        std::vector<Leaf> leaves;
+        for (uint8_t i = next; i < next + batch_size; i++) {
+            const std::vector<uint8_t> data({ i, 1, 2 });
+            leaves.push_back(Leaf::Create(LeafIndex::At(i), data));
+            expected.Add(data);
+        }
+        next += batch_size;
+
+        mem.AddLeaves(leaves);
+        cache.AddLeaves(leaves);
+
+        BOOST_REQUIRE(mem.GetNumLeaves() == expected.GetNumLeaves());
+        for (uint64_t pos = 0; pos < expected.GetNumNodes(); pos++) {
+            BOOST_REQUIRE(mem.GetHash(Index::At(pos)) == expected.GetHash(Index::At(pos)));
+        }
+
+        BOOST_REQUIRE(cache.Root() == expected.Root());
+
+        // Flushing writes the leaves to the PMMR in a batch too
+        cache.Flush(file_index++, nullptr);
+        BOOST_REQUIRE(pmmr->Root() == expected.Root());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(PMMRCompact)
+{
+    const FilePath mmr_dir = GetDataDir() / "mmr";
+    PMMR::Ptr pmmr = PMMR::Open('O', mmr_dir, 0, GetDB(), nullptr);
+
+    MemMMR expected;
+    std::vector<Leaf> leaves;
+    for (uint8_t i = 0; i < 20; i++) {
+        const std::vector<uint8_t> data({ i, 1, 2 });
+        leaves.push_back(Leaf::Create(LeafIndex::At(i), data));
+        expected.Add(data);
+    }
+
+    PMMRCache cache(pmmr);
+    cache.AddLeaves(leaves);
+    cache.Flush(1, nullptr);
+
+    const mw::Hash root = pmmr->Root();
+    const uint64_t file_size = File(PMMR::GetPath(mmr_dir, 'O', 1)).GetSize();
+
+    // Spend leaves 0-7, which compacts everything below their subtree's root.
+    // Leaf 9 is spent too, but its sibling isn't, so it must be kept.
+    BitSet unspent(20);
+    for (uint64_t i = 0; i < 20; i++) {
+        unspent.set(i, i >= 8 && i != 9);
+    }
+
+    pmmr->Compact(2, MMRUtil::BuildCompactBitSet(20, unspent), nullptr);
+
+    BOOST_REQUIRE(pmmr->Root() == root);
+    BOOST_REQUIRE(pmmr->GetNumLeaves() == 20);
+    BOOST_REQUIRE(File(PMMR::GetPath(mmr_dir, 'O', 2)).GetSize() == file_size - (14 * mw::Hash::size()));
+    BOOST_REQUIRE(pmmr->IsCompacted(LeafIndex::At(3)));
+    BOOST_REQUIRE(!pmmr->IsCompacted(LeafIndex::At(8)));
+    BOOST_REQUIRE(!pmmr->IsCompacted(LeafIndex::At(9)));
+    BOOST_REQUIRE(pmmr->GetHash(Index::At(14)) == expected.GetHash(Index::At(14)));
+    BOOST_REQUIRE(pmmr->GetLeaf(LeafIndex::At(9)) == leaves[9]);
+    BOOST_CHECK_THROW(pmmr->GetLeaf(LeafIndex::At(3)), std::exception);
+
+    // The new files can be reopened
+    PMMR::Ptr reopened = PMMR::Open('O', mmr_dir, 2, GetDB(), PruneList::Open(mmr_dir, 2));
+    BOOST_REQUIRE(reopened->Root() == root);
+    BOOST_REQUIRE(reopened->IsCompacted(LeafIndex::At(0)));
+
+    // Appending and rewinding still work on top of the compacted files
+    PMMRCache cache2(pmmr);
+    BOOST_REQUIRE(cache2.IsCompacted(LeafIndex::At(0)));
+
+    for (uint8_t i = 20; i < 25; i++) {
+        const std::vector<uint8_t> data({ i, 1, 2 });
+        cache2.Add(data);
+        expected.Add(data);
+    }
+
+    BOOST_REQUIRE(cache2.Root() == expected.Root());
+    cache2.Flush(3, nullptr);
+    BOOST_REQUIRE(pmmr->Root() == expected.Root());
+
+    PMMRCache cache3(pmmr);
+    cache3.Rewind(20);
+    BOOST_REQUIRE(cache3.Root() == root);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
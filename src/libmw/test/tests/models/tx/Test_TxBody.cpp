@@ -2,6 +2,9 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <mw/exceptions/ValidationException.h>
+#include <mw/models/tx/TxBody.h>
+
 #include <test_framework/TestMWEB.h>
 #include <test_framework/TxBuilder.h>
 
@@ -35,4 +38,41 @@ BOOST_AUTO_TEST_CASE(Test_TxBody)
     BOOST_REQUIRE(txBody.GetTotalFee() == fee);
 }
 
+BOOST_AUTO_TEST_CASE(CachedElements)
+{
+    mw::Transaction::CPtr tx = test::TxBuilder()
+        .AddInput(50)
+        .AddOutput(20).AddOutput(25)
+        .AddPlainKernel(5)
+        .Build().GetTransaction();
+
+    // Validating the transaction caches its elements, so its body validates from the cache
+    tx->Validate();
+    tx->GetBody().Validate();
+
+    // Outputs with their signatures swapped aren't in the cache, and fail verification
+    const std::vector<Output>& outputs = tx->GetOutputs();
+    std::vector<Output> swapped;
+    for (size_t i = 0; i < outputs.size(); i++) {
+        const Output& output = outputs[i];
+        swapped.push_back(Output(
+            output.GetCommitment(),
+            output.GetSenderPubKey(),
+            output.GetReceiverPubKey(),
+            output.GetOutputMessage(),
+            output.GetRangeProof(),
+            outputs[outputs.size() - i - 1].GetSignature()
+        ));
+    }
+    std::sort(swapped.begin(), swapped.end(), OutputSort);
+
+    TxBody tampered(tx->GetInputs(), swapped, tx->GetKernels());
+    BOOST_CHECK_THROW(tampered.Validate(), ValidationException);
+
+    // An emptied cache still verifies
+    TxBody::SetCacheSize(0);
+    tx->GetBody().Validate();
+    BOOST_CHECK_THROW(tampered.Validate(), ValidationException);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
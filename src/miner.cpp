@@ -13,16 +13,21 @@
 #include <consensus/merkle.h>
 #include <consensus/tx_verify.h>
 #include <consensus/validation.h>
+#include <crypto/common.h>
+#include <crypto/scrypt.h>
 #include <mw/consensus/Params.h>
 #include <policy/feerate.h>
 #include <policy/policy.h>
 #include <pow.h>
 #include <primitives/transaction.h>
+#include <shutdown.h>
 #include <timedata.h>
 #include <util/moneystr.h>
+#include <util/strencodings.h>
 #include <util/system.h>
 
 #include <algorithm>
+#include <thread>
 #include <utility>
 
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev)
@@ -521,6 +526,91 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
     }
 }
 
+BlockTemplateCache::BlockTemplateCache(const CTxMemPool& mempool, int64_t refresh_interval)
+    : m_mempool(mempool), m_refresh_interval(refresh_interval) {}
+
+std::shared_ptr<const CBlockTemplate> BlockTemplateCache::Rebuild()
+{
+    AssertLockHeld(cs_main);
+    // Read before assembling so that changes made meanwhile count as newer
+    const unsigned int transactions_updated = m_mempool.GetTransactionsUpdated();
+    std::shared_ptr<const CBlockTemplate> block_template = BlockAssembler(m_mempool, Params()).CreateNewBlock(CScript() << OP_TRUE);
+    if (!block_template) {
+        return nullptr;
+    }
+
+    LOCK(m_mutex);
+    m_template = block_template;
+    m_tip = ::ChainActive().Tip();
+    m_transactions_updated = transactions_updated;
+    m_time = GetTime();
+    return block_template;
+}
+
+std::unique_ptr<CBlockTemplate> BlockTemplateCache::Get(const CScript& scriptPubKey, int64_t max_age)
+{
+    LOCK(cs_main);
+    std::shared_ptr<const CBlockTemplate> block_template;
+    {
+        LOCK(m_mutex);
+        m_active = true;
+        if (m_template && m_tip == ::ChainActive().Tip() &&
+            (m_transactions_updated == m_mempool.GetTransactionsUpdated() || GetTime() - m_time <= max_age)) {
+            block_template = m_template;
+        }
+    }
+    if (!block_template) {
+        block_template = Rebuild();
+        if (!block_template) {
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<CBlockTemplate> result = MakeUnique<CBlockTemplate>(*block_template);
+    CMutableTransaction coinbase(*result->block.vtx[0]);
+    coinbase.vout[0].scriptPubKey = scriptPubKey;
+    result->block.vtx[0] = MakeTransactionRef(std::move(coinbase));
+    result->vTxSigOpsCost[0] = WITNESS_SCALE_FACTOR * GetLegacySigOpCount(*result->block.vtx[0]);
+    return result;
+}
+
+void BlockTemplateCache::RefreshIfStale(bool tip_changed)
+{
+    {
+        LOCK(m_mutex);
+        if (!m_active || (!tip_changed && GetTime() - m_time < m_refresh_interval)) {
+            return;
+        }
+    }
+    try {
+        LOCK(cs_main);
+        Rebuild();
+    } catch (const std::exception& e) {
+        // Leave it to the next request, which reports the error to its caller
+        LogPrintf("%s: failed to refresh block template: %s\n", __func__, e.what());
+        LOCK(m_mutex);
+        m_template.reset();
+    }
+}
+
+void BlockTemplateCache::UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload)
+{
+    if (fInitialDownload) return;
+    RefreshIfStale(/* tip_changed */ true);
+}
+
+void BlockTemplateCache::TransactionAddedToMempool(const CTransactionRef& tx, uint64_t mempool_sequence)
+{
+    RefreshIfStale(/* tip_changed */ false);
+}
+
+void BlockTemplateCache::TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence)
+{
+    // Removals for a new block are followed by UpdatedBlockTip
+    if (reason == MemPoolRemovalReason::BLOCK || reason == MemPoolRemovalReason::CONFLICT) return;
+    RefreshIfStale(/* tip_changed */ false);
+}
+
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce)
 {
     // Update nExtraNonce
@@ -539,3 +629,67 @@ void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned
     pblock->vtx[0] = MakeTransactionRef(std::move(txCoinbase));
     pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
 }
+
+bool ScanProofOfWork(CBlockHeader* pblock, uint64_t& max_tries, const Consensus::Params& consensusParams, int nThreads)
+{
+    // Same 80-byte layout that CPureBlockHeader::GetPoWHash() hashes
+    CPureBlockHeader pure;
+    pure.nVersion = pblock->nVersion;
+    pure.hashPrevBlock = pblock->hashPrevBlock;
+    pure.hashMerkleRoot = pblock->hashMerkleRoot;
+    pure.nTime = pblock->nTime;
+    pure.nBits = pblock->nBits;
+    pure.nNonce = 0;
+    unsigned char header[80];
+    memcpy(header, BEGIN(pure.nVersion), 80);
+
+    const uint64_t lanes = scrypt_multi_lanes();
+    const uint64_t threads = std::max(nThreads, 1);
+    // Start with a single batch so that easy targets (regtest) don't pay for
+    // thread startup, then grow the rounds until every worker has a few
+    // batches to hash.
+    uint64_t round_size = lanes;
+    const uint64_t max_round_size = lanes * threads * 16;
+
+    std::vector<unsigned char> inputs;
+    std::vector<unsigned char> outputs;
+    while (max_tries > 0 && pblock->nNonce < std::numeric_limits<uint32_t>::max() && !ShutdownRequested()) {
+        const uint64_t count = std::min({round_size, max_tries, uint64_t{std::numeric_limits<uint32_t>::max() - pblock->nNonce}});
+        inputs.resize(count * 80);
+        outputs.resize(count * 32);
+        for (uint64_t i = 0; i < count; i++) {
+            memcpy(&inputs[i * 80], header, 76);
+            WriteLE32(&inputs[i * 80 + 76], pblock->nNonce + i);
+        }
+
+        const uint64_t batches = (count + lanes - 1) / lanes;
+        const uint64_t workers = std::min(threads, batches);
+        const uint64_t per_worker = (batches + workers - 1) / workers * lanes;
+        auto hash_range = [&](uint64_t begin) {
+            const uint64_t end = std::min(begin + per_worker, count);
+            scrypt_1024_1_1_256_multi((const char*)&inputs[begin * 80], (char*)&outputs[begin * 32], end - begin);
+        };
+        std::vector<std::thread> pool;
+        for (uint64_t w = 1; w < workers; w++) {
+            pool.emplace_back(hash_range, w * per_worker);
+        }
+        hash_range(0);
+        for (std::thread& t : pool) {
+            t.join();
+        }
+
+        for (uint64_t i = 0; i < count; i++) {
+            uint256 hash;
+            memcpy(hash.begin(), &outputs[i * 32], 32);
+            if (CheckProofOfWork(hash, pblock->nBits, consensusParams)) {
+                pblock->nNonce += i;
+                max_tries -= i;
+                return true;
+            }
+        }
+        pblock->nNonce += count;
+        max_tries -= count;
+        round_size = std::min(round_size * 2, max_round_size);
+    }
+    return false;
+}
@@ -10,6 +10,7 @@
 #include <primitives/block.h>
 #include <txmempool.h>
 #include <validation.h>
+#include <validationinterface.h>
 #include <mweb/mweb_miner.h>
 
 #include <memory>
@@ -25,6 +26,8 @@ class CScript;
 namespace Consensus { struct Params; };
 
 static const bool DEFAULT_PRINTPRIORITY = false;
+/** Minimum age, in seconds, before mempool changes cause a cached block template to be rebuilt */
+static const int64_t DEFAULT_TEMPLATE_REFRESH_INTERVAL = 5;
 
 struct CBlockTemplate
 {
@@ -209,6 +212,50 @@ private:
     int UpdatePackagesForAdded(const CTxMemPool::setEntries& alreadyAdded, indexed_modified_transaction_set& mapModifiedTx) EXCLUSIVE_LOCKS_REQUIRED(m_mempool.cs);
 };
 
+/**
+ * Block template for the active tip, shared by the mining RPCs.
+ *
+ * Templates are assembled once with a placeholder coinbase output and each
+ * caller receives a copy paying to its own script, so requests for several
+ * payout addresses or merge-mined chains don't each run CreateNewBlock. Once
+ * a template has been requested, new tips and mempool changes rebuild it on
+ * the validation interface's background thread (mempool changes at most once
+ * per refresh interval), so requests normally find a current template.
+ */
+class BlockTemplateCache final : public CValidationInterface
+{
+public:
+    explicit BlockTemplateCache(const CTxMemPool& mempool, int64_t refresh_interval = DEFAULT_TEMPLATE_REFRESH_INTERVAL);
+
+    /**
+     * Return a template on the active tip whose first coinbase output pays to
+     * scriptPubKey. The cached template is used if it was built on the tip and
+     * either the mempool hasn't changed since or it is at most max_age seconds
+     * old; otherwise a new one is assembled.
+     */
+    std::unique_ptr<CBlockTemplate> Get(const CScript& scriptPubKey, int64_t max_age);
+
+protected:
+    void UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload) override;
+    void TransactionAddedToMempool(const CTransactionRef& tx, uint64_t mempool_sequence) override;
+    void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) override;
+
+private:
+    std::shared_ptr<const CBlockTemplate> Rebuild() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    void RefreshIfStale(bool tip_changed);
+
+    const CTxMemPool& m_mempool;
+    const int64_t m_refresh_interval;
+
+    Mutex m_mutex;
+    std::shared_ptr<const CBlockTemplate> m_template GUARDED_BY(m_mutex);
+    const CBlockIndex* m_tip GUARDED_BY(m_mutex){nullptr};
+    unsigned int m_transactions_updated GUARDED_BY(m_mutex){0};
+    int64_t m_time GUARDED_BY(m_mutex){0};
+    //! Only keep the template current in the background once it has been used
+    bool m_active GUARDED_BY(m_mutex){false};
+};
+
 /** Modify the extranonce in a block */
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce);
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev);
@@ -216,4 +263,14 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
 /** Update an old GenerateCoinbaseCommitment from CreateNewBlock after the block txs have changed */
 void RegenerateCommitments(CBlock& block);
 
+/**
+ * Search the nonces from pblock->nNonce upwards for one that satisfies the
+ * block's proof-of-work target. Each round of nonces is split across up to
+ * nThreads workers hashing with the multi-lane scrypt kernels, and the lowest
+ * solving nonce wins, so the result matches a sequential scan. max_tries is
+ * reduced by the number of failed attempts. Returns true with pblock->nNonce
+ * set to the solution; otherwise pblock->nNonce is the next untried nonce.
+ */
+bool ScanProofOfWork(CBlockHeader* pblock, uint64_t& max_tries, const Consensus::Params& consensusParams, int nThreads);
+
 #endif // BITCOIN_MINER_H
@@ -39,14 +39,34 @@ bool Wallet::UpgradeCoins()
 
 std::vector<mw::Coin> Wallet::RewindOutputs(const CTransaction& tx)
 {
+    if (tx.HasMWEBTx()) {
+        return RewindOutputs(tx.mweb_tx.m_transaction->GetOutputs());
+    }
+
+    return {};
+}
+
+std::vector<mw::Coin> Wallet::RewindOutputs(const std::vector<Output>& outputs)
+{
+    mw::Keychain::Ptr keychain = GetKeychain();
+
+    // Outputs that fail the view tag check can't be ours, unless they're already known coins.
+    std::vector<bool> candidates(outputs.size(), false);
+    if (keychain) {
+        for (const size_t index : keychain->ScanOutputs(outputs)) {
+            candidates[index] = true;
+        }
+    }
+
     std::vector<mw::Coin> coins;
+    for (size_t i = 0; i < outputs.size(); i++) {
+        if (!candidates[i] && !m_coins.count(outputs[i].GetOutputID())) {
+            continue;
+        }
 
-    if (tx.HasMWEBTx()) {
-        for (const Output& output : tx.mweb_tx.m_transaction->GetOutputs()) {
-            mw::Coin mweb_coin;
-            if (RewindOutput(output, mweb_coin)) {
-                coins.push_back(mweb_coin);
-            }
+        mw::Coin mweb_coin;
+        if (RewindOutput(outputs[i], mweb_coin)) {
+            coins.push_back(mweb_coin);
         }
     }
 
@@ -38,6 +38,10 @@ public:
     std::vector<mw::Coin> RewindOutputs(const CTransaction& tx);
     bool RewindOutput(const Output& output, mw::Coin& coin);
 
+    // Rewinds all of the outputs, checking their view tags in parallel first.
+    // Returns the coins that belong to the wallet, in the order of the outputs.
+    std::vector<mw::Coin> RewindOutputs(const std::vector<Output>& outputs);
+
     bool GetStealthAddress(const mw::Coin& coin, StealthAddress& address) const;
     bool GetStealthAddress(const uint32_t index, StealthAddress& address) const;
 
@@ -17,6 +17,7 @@
 #include <mw/mmr/Segment.h>
 #include <netbase.h>
 #include <netmessagemaker.h>
+#include <optional.h>
 #include <policy/fees.h>
 #include <policy/policy.h>
 #include <primitives/block.h>
@@ -32,7 +33,11 @@
 #include <util/system.h>
 #include <validation.h>
 
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <thread>
+#include <tuple>
 #include <typeinfo>
 
 /** Expiration time for orphan transactions in seconds */
@@ -107,6 +112,12 @@ static const int MAX_BLOCKTXN_DEPTH = 10;
 static const int MAX_MWEB_LEAFSET_DEPTH = 10;
 /** Maximum number of MWEB UTXOs that can be requested in a batch. */
 static const uint16_t MAX_REQUESTED_MWEB_UTXOS = 4096;
+/** Number of threads building the MWEB leafsets and UTXO segments requested by peers. */
+static const int MWEB_REQUEST_THREADS = 2;
+/** Maximum number of MWEB leafset and UTXO requests queued for a single peer. */
+static const size_t MAX_QUEUED_MWEB_REQUESTS_PER_PEER = 16;
+/** Maximum size in bytes of the cached MWEB leafset and UTXO responses. */
+static const size_t MAX_MWEB_RESPONSE_CACHE_SIZE = 32 << 20;
 /** Size of the "block download window": how far ahead of our current height do we fetch?
  *  Larger windows tolerate larger download speed differences between peer, but increase the potential
  *  degree of disordering of blocks on disk (which make reindexing and pruning harder). We'll probably
@@ -1214,6 +1225,115 @@ static bool BlockRequestAllowed(const CBlockIndex* pindex, const Consensus::Para
         (GetBlockProofEquivalentTime(*pindexBestHeader, *pindex, *pindexBestHeader, consensusParams) < STALE_RELAY_AGE_LIMIT);
 }
 
+struct MWEBLeafsetMsg
+{
+    MWEBLeafsetMsg() = default;
+    MWEBLeafsetMsg(uint256 block_hash_in, BitSet leafset_in)
+        : block_hash(std::move(block_hash_in)), leafset(std::move(leafset_in)) { }
+
+    SERIALIZE_METHODS(MWEBLeafsetMsg, obj) { READWRITE(obj.block_hash, obj.leafset); }
+
+    uint256 block_hash;
+    BitSet leafset;
+};
+
+struct GetMWEBUTXOsMsg
+{
+    GetMWEBUTXOsMsg() = default;
+
+    SERIALIZE_METHODS(GetMWEBUTXOsMsg, obj)
+    {
+        READWRITE(obj.block_hash, COMPACTSIZE(obj.start_index), obj.num_requested, obj.output_format);
+    }
+
+    uint256 block_hash;
+    uint64_t start_index;
+    uint16_t num_requested;
+    uint8_t output_format;
+};
+
+struct MWEBUTXOsMsg
+{
+    MWEBUTXOsMsg() = default;
+
+    SERIALIZE_METHODS(MWEBUTXOsMsg, obj)
+    {
+        READWRITE(obj.block_hash, COMPACTSIZE(obj.start_index), obj.output_format, obj.utxos, obj.proof_hashes);
+    }
+
+    uint256 block_hash;
+    uint64_t start_index;
+    uint8_t output_format;
+    std::vector<NetUTXO> utxos;
+    std::vector<mw::Hash> proof_hashes;
+};
+
+/** A MSG_MWEB_LEAFSET getdata or a getmwebutxos request, queued for the MWEB request threads. */
+struct MWEBRequest
+{
+    NodeId peer;
+    int version;
+    bool noban;
+    uint256 block_hash;
+    //! Unset for a leafset request
+    Optional<GetMWEBUTXOsMsg> get_utxos;
+};
+
+/**
+ * Builds the MWEB leafsets and UTXO segments requested by light clients on a small pool of threads,
+ * so the message handler thread can keep processing blocks and other peers' messages meanwhile.
+ *
+ * Queued requests for the same block are served from a single rewind of the MWEB state, and the
+ * serialized responses are cached while their block is within MAX_MWEB_LEAFSET_DEPTH of the tip,
+ * since light clients syncing at the same time request the same segments of the same blocks.
+ */
+class MWEBRequestPool
+{
+public:
+    MWEBRequestPool(const CChainParams& chainparams, CConnman& connman, ChainstateManager& chainman);
+    ~MWEBRequestPool();
+
+    /** Queue a request. Returns false if the peer already has too many requests queued. */
+    bool Enqueue(MWEBRequest&& request);
+
+private:
+    //! Block hash, whether it's a leafset, start index, number requested, output format and version
+    using CacheKey = std::tuple<uint256, bool, uint64_t, uint16_t, uint8_t, int>;
+
+    struct Response
+    {
+        int height;
+        std::string type;
+        std::vector<unsigned char> data;
+    };
+    using ResponsePtr = std::shared_ptr<const Response>;
+
+    static CacheKey GetCacheKey(const MWEBRequest& request);
+
+    void ThreadWorker();
+    void ProcessRequests(const std::vector<MWEBRequest>& requests);
+    ResponsePtr BuildResponse(const MWEBRequest& request, const CCoinsViewCache& view, const CBlockIndex* pindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+    ResponsePtr GetCachedResponse(const CacheKey& key);
+    void CacheResponse(const CacheKey& key, const ResponsePtr& response, const int min_height);
+
+    const CChainParams& m_chainparams;
+    CConnman& m_connman;
+    ChainstateManager& m_chainman;
+
+    Mutex m_queue_mutex;
+    std::condition_variable m_queue_cond;
+    std::deque<MWEBRequest> m_queue GUARDED_BY(m_queue_mutex);
+    bool m_stop GUARDED_BY(m_queue_mutex){false};
+    std::vector<std::thread> m_threads;
+
+    Mutex m_cache_mutex;
+    std::map<CacheKey, ResponsePtr> m_cache GUARDED_BY(m_cache_mutex);
+    //! Cached keys, oldest first
+    std::deque<CacheKey> m_cache_order GUARDED_BY(m_cache_mutex);
+    size_t m_cache_size GUARDED_BY(m_cache_mutex){0};
+};
+
 PeerManager::PeerManager(const CChainParams& chainparams, CConnman& connman, BanMan* banman,
                          CScheduler& scheduler, ChainstateManager& chainman, CTxMemPool& pool)
     : m_chainparams(chainparams),
@@ -1221,6 +1341,7 @@ PeerManager::PeerManager(const CChainParams& chainparams, CConnman& connman, Ban
       m_banman(banman),
       m_chainman(chainman),
       m_mempool(pool),
+      m_mweb_requests(MakeUnique<MWEBRequestPool>(chainparams, connman, chainman)),
       m_stale_tip_check_time(0)
 {
     // Initialize global variables that cannot be constructed at startup.
@@ -1249,6 +1370,8 @@ PeerManager::PeerManager(const CChainParams& chainparams, CConnman& connman, Ban
     scheduler.scheduleFromNow([&] { ReattemptInitialBroadcast(scheduler); }, delta);
 }
 
+PeerManager::~PeerManager() = default;
+
 /**
  * Evict orphan txn pool entries (EraseOrphanTx) based on a newly connected
  * block, remember the recently confirmed transactions, and delete tracked
@@ -1727,103 +1850,251 @@ void static ProcessGetBlockData(CNode& pfrom, const CChainParams& chainparams, c
     }
 }
 
-struct MWEBLeafsetMsg
+MWEBRequestPool::MWEBRequestPool(const CChainParams& chainparams, CConnman& connman, ChainstateManager& chainman)
+    : m_chainparams(chainparams), m_connman(connman), m_chainman(chainman)
 {
-    MWEBLeafsetMsg() = default;
-    MWEBLeafsetMsg(uint256 block_hash_in, BitSet leafset_in)
-        : block_hash(std::move(block_hash_in)), leafset(std::move(leafset_in)) { }
+    for (int i = 0; i < MWEB_REQUEST_THREADS; i++) {
+        m_threads.emplace_back(&TraceThread<std::function<void()>>, "mwebreq", [this] { ThreadWorker(); });
+    }
+}
 
-    SERIALIZE_METHODS(MWEBLeafsetMsg, obj) { READWRITE(obj.block_hash, obj.leafset); }
+MWEBRequestPool::~MWEBRequestPool()
+{
+    WITH_LOCK(m_queue_mutex, m_stop = true);
+    m_queue_cond.notify_all();
 
-    uint256 block_hash;
-    BitSet leafset;
-};
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
 
-static void ProcessGetMWEBLeafset(CNode& pfrom, const ChainstateManager& chainman, const CChainParams& chainparams, const CInv& inv, CConnman& connman)
+bool MWEBRequestPool::Enqueue(MWEBRequest&& request)
 {
-    ActivateBestChainIfNeeded(chainparams, inv);
+    {
+        LOCK(m_queue_mutex);
+        const NodeId peer = request.peer;
+        const size_t num_queued = std::count_if(m_queue.cbegin(), m_queue.cend(), [peer](const MWEBRequest& queued) { return queued.peer == peer; });
+        if (num_queued >= MAX_QUEUED_MWEB_REQUESTS_PER_PEER) {
+            return false;
+        }
 
-    LOCK(cs_main);
-    if (chainman.ActiveChainstate().IsInitialBlockDownload()) {
-        LogPrint(BCLog::NET, "Ignoring mweb leafset request from peer=%d because node is in initial block download\n", pfrom.GetId());
-        return;
+        m_queue.push_back(std::move(request));
     }
 
-    CBlockIndex* pindex = LookupBlockIndex(inv.hash);
-    if (!pindex || !chainman.ActiveChain().Contains(pindex)) {
-        LogPrint(BCLog::NET, "Ignoring mweb leafset request from peer=%d because requested block hash is not in active chain\n", pfrom.GetId());
-        return;
-    }
+    m_queue_cond.notify_one();
+    return true;
+}
 
-    // TODO: Add an outbound limit
+MWEBRequestPool::CacheKey MWEBRequestPool::GetCacheKey(const MWEBRequest& request)
+{
+    if (!request.get_utxos) {
+        return CacheKey{request.block_hash, true, 0, 0, 0, request.version};
+    }
 
-    // For performance reasons, we limit how many blocks can be undone in order to rebuild the leafset
-    if (chainman.ActiveChain().Tip()->nHeight - pindex->nHeight > MAX_MWEB_LEAFSET_DEPTH) {
-        LogPrint(BCLog::NET, "Ignore mweb leafset request below MAX_MWEB_LEAFSET_DEPTH threshold from peer=%d\n", pfrom.GetId());
+    return CacheKey{
+        request.block_hash,
+        false,
+        request.get_utxos->start_index,
+        request.get_utxos->num_requested,
+        request.get_utxos->output_format,
+        request.version
+    };
+}
 
-        // disconnect node and prevent it from stalling (would otherwise wait for the MWEB leafset)
-        if (!pfrom.HasPermission(PF_NOBAN)) {
-            pfrom.fDisconnect = true;
+void MWEBRequestPool::ThreadWorker()
+{
+    while (true) {
+        std::vector<MWEBRequest> requests;
+        {
+            WAIT_LOCK(m_queue_mutex, lock);
+            m_queue_cond.wait(lock, [this]() EXCLUSIVE_LOCKS_REQUIRED(m_queue_mutex) { return m_stop || !m_queue.empty(); });
+            if (m_stop) return;
+
+            // Take every queued request for the same block, so they share one rewind.
+            const uint256 block_hash = m_queue.front().block_hash;
+            for (auto it = m_queue.begin(); it != m_queue.end();) {
+                if (it->block_hash == block_hash) {
+                    requests.push_back(std::move(*it));
+                    it = m_queue.erase(it);
+                } else {
+                    ++it;
+                }
+            }
         }
 
-        return;
+        ProcessRequests(requests);
     }
+}
 
-    // Pruned nodes may have deleted the block, so check whether it's available before trying to send.
-    if (!(pindex->nStatus & BLOCK_HAVE_DATA) || !(pindex->nStatus & BLOCK_HAVE_MWEB)) {
-        LogPrint(BCLog::NET, "Ignoring mweb leafset request from peer=%d because block is either pruned or lacking mweb data\n", pfrom.GetId());
+MWEBRequestPool::ResponsePtr MWEBRequestPool::BuildResponse(const MWEBRequest& request, const CCoinsViewCache& view, const CBlockIndex* pindex)
+{
+    AssertLockHeld(cs_main);
+    auto mweb_cache = view.GetMWEBCacheView();
+    const CNetMsgMaker msg_maker(request.version);
 
-        if (!pfrom.HasPermission(PF_NOBAN)) {
-            pfrom.fDisconnect = true;
+    CSerializedNetMsg msg;
+    if (!request.get_utxos) {
+        MWEBLeafsetMsg leafset_msg(pindex->GetBlockHash(), mweb_cache->GetLeafSet()->ToBitSet());
+        msg = msg_maker.Make(NetMsgType::MWEBLEAFSET, leafset_msg);
+    } else {
+        const GetMWEBUTXOsMsg& get_utxos = *request.get_utxos;
+        mmr::Segment segment = mmr::SegmentFactory::Assemble(
+            *mweb_cache->GetOutputPMMR(),
+            *mweb_cache->GetLeafSet(),
+            mmr::LeafIndex::At(get_utxos.start_index),
+            get_utxos.num_requested
+        );
+        if (segment.leaves.empty()) {
+            return nullptr;
+        }
+
+        std::vector<NetUTXO> utxos;
+        utxos.reserve(segment.leaves.size());
+        for (const mmr::Leaf& leaf : segment.leaves) {
+            UTXO::CPtr utxo = mweb_cache->GetUTXO(leaf.vec());
+            if (!utxo) {
+                return nullptr;
+            }
+
+            utxos.push_back(NetUTXO(get_utxos.output_format, utxo));
         }
-        return;
-    }
 
-    // Rewind leafset to block height
-    BlockValidationState state;
-    CCoinsViewCache temp_view(&chainman.ActiveChainstate().CoinsTip());
-    if (!ActivateArbitraryChain(state, temp_view, chainparams, pindex)) {
-        pfrom.fDisconnect = true;
-        return;
+        std::vector<mw::Hash> proof_hashes = segment.hashes;
+        if (segment.lower_peak) {
+            proof_hashes.push_back(*segment.lower_peak);
+        }
+
+        MWEBUTXOsMsg utxos_msg{
+            get_utxos.block_hash,
+            get_utxos.start_index,
+            get_utxos.output_format,
+            std::move(utxos),
+            std::move(proof_hashes)
+        };
+        msg = msg_maker.Make(NetMsgType::MWEBUTXOS, utxos_msg);
     }
 
-    // Serve leafset to peer
-    MWEBLeafsetMsg leafset_msg(pindex->GetBlockHash(), temp_view.GetMWEBCacheView()->GetLeafSet()->ToBitSet());
-    connman.PushMessage(&pfrom, CNetMsgMaker(pfrom.GetCommonVersion()).Make(NetMsgType::MWEBLEAFSET, leafset_msg));
+    return std::make_shared<const Response>(Response{pindex->nHeight, std::move(msg.m_type), std::move(msg.data)});
 }
 
-struct GetMWEBUTXOsMsg
+MWEBRequestPool::ResponsePtr MWEBRequestPool::GetCachedResponse(const CacheKey& key)
 {
-    GetMWEBUTXOsMsg() = default;
+    LOCK(m_cache_mutex);
+    auto it = m_cache.find(key);
+    return it != m_cache.end() ? it->second : nullptr;
+}
 
-    SERIALIZE_METHODS(GetMWEBUTXOsMsg, obj)
-    {
-        READWRITE(obj.block_hash, COMPACTSIZE(obj.start_index), obj.num_requested, obj.output_format);
-    }
+void MWEBRequestPool::CacheResponse(const CacheKey& key, const ResponsePtr& response, const int min_height)
+{
+    LOCK(m_cache_mutex);
+    if (!m_cache.emplace(key, response).second) return;
+    m_cache_order.push_back(key);
+    m_cache_size += response->data.size();
+
+    // Responses for blocks that are too deep will no longer be served.
+    // Beyond that, evict the oldest responses until the cache fits.
+    for (auto it = m_cache_order.begin(); it != m_cache_order.end();) {
+        const ResponsePtr& cached = m_cache.at(*it);
+        if (cached->height >= min_height && m_cache_size <= MAX_MWEB_RESPONSE_CACHE_SIZE) {
+            ++it;
+            continue;
+        }
 
-    uint256 block_hash;
-    uint64_t start_index;
-    uint16_t num_requested;
-    uint8_t output_format;
-};
+        m_cache_size -= cached->data.size();
+        m_cache.erase(*it);
+        it = m_cache_order.erase(it);
+    }
+}
 
-struct MWEBUTXOsMsg
+void MWEBRequestPool::ProcessRequests(const std::vector<MWEBRequest>& requests)
 {
-    MWEBUTXOsMsg() = default;
+    assert(!requests.empty());
+
+    enum class Result { NONE, DISCONNECT_UNLESS_NOBAN, DISCONNECT, SEND };
+    std::vector<std::pair<Result, ResponsePtr>> results(requests.size(), {Result::NONE, nullptr});
+
+    ActivateBestChainIfNeeded(m_chainparams, CInv(MSG_BLOCK, requests.front().block_hash));
 
-    SERIALIZE_METHODS(MWEBUTXOsMsg, obj)
     {
-        READWRITE(obj.block_hash, COMPACTSIZE(obj.start_index), obj.output_format, obj.utxos, obj.proof_hashes);
+        LOCK(cs_main);
+        if (m_chainman.ActiveChainstate().IsInitialBlockDownload()) {
+            LogPrint(BCLog::NET, "Ignoring %u mweb leafset/utxo requests because node is in initial block download\n", requests.size());
+            return;
+        }
+
+        CBlockIndex* pindex = LookupBlockIndex(requests.front().block_hash);
+        if (!pindex || !m_chainman.ActiveChain().Contains(pindex)) {
+            LogPrint(BCLog::NET, "Ignoring %u mweb leafset/utxo requests because requested block hash is not in active chain\n", requests.size());
+            return;
+        }
+
+        // TODO: Add an outbound limit
+
+        // For performance reasons, we limit how many blocks can be undone in order to rebuild the leafset.
+        // Pruned nodes may have deleted the block, so also check whether it's available before trying to send.
+        // Peers are disconnected so they don't stall waiting for the response.
+        const int min_height = m_chainman.ActiveChain().Height() - MAX_MWEB_LEAFSET_DEPTH;
+        if (pindex->nHeight < min_height) {
+            LogPrint(BCLog::NET, "Ignore %u mweb leafset/utxo requests below MAX_MWEB_LEAFSET_DEPTH threshold\n", requests.size());
+            std::fill(results.begin(), results.end(), std::make_pair(Result::DISCONNECT_UNLESS_NOBAN, nullptr));
+        } else if (!(pindex->nStatus & BLOCK_HAVE_DATA) || !(pindex->nStatus & BLOCK_HAVE_MWEB)) {
+            LogPrint(BCLog::NET, "Ignoring %u mweb leafset/utxo requests because block is either pruned or lacking mweb data\n", requests.size());
+            std::fill(results.begin(), results.end(), std::make_pair(Result::DISCONNECT_UNLESS_NOBAN, nullptr));
+        } else {
+            // Rewind leafset to block height, only if some response isn't cached already
+            std::unique_ptr<CCoinsViewCache> temp_view;
+            for (size_t i = 0; i < requests.size(); i++) {
+                const CacheKey key = GetCacheKey(requests[i]);
+                ResponsePtr response = GetCachedResponse(key);
+                if (!response) {
+                    if (!temp_view) {
+                        BlockValidationState state;
+                        temp_view = MakeUnique<CCoinsViewCache>(&m_chainman.ActiveChainstate().CoinsTip());
+                        if (!ActivateArbitraryChain(state, *temp_view, m_chainparams, pindex)) {
+                            std::fill(results.begin() + i, results.end(), std::make_pair(Result::DISCONNECT, nullptr));
+                            break;
+                        }
+                    }
+
+                    try {
+                        response = BuildResponse(requests[i], *temp_view, pindex);
+                    } catch (const std::exception& e) {
+                        LogPrint(BCLog::NET, "Failed to build mweb response for peer=%d: %s\n", requests[i].peer, e.what());
+                    }
+
+                    if (!response) {
+                        LogPrint(BCLog::NET, "Could not build mweb leafset/utxos requested by peer=%d\n", requests[i].peer);
+                        results[i] = {Result::DISCONNECT, nullptr};
+                        continue;
+                    }
+
+                    CacheResponse(key, response, min_height);
+                }
+
+                results[i] = {Result::SEND, response};
+            }
+        }
     }
 
-    uint256 block_hash;
-    uint64_t start_index;
-    uint8_t output_format;
-    std::vector<NetUTXO> utxos;
-    std::vector<mw::Hash> proof_hashes;
-};
+    for (size_t i = 0; i < requests.size(); i++) {
+        const Result result = results[i].first;
+        if (result == Result::NONE) continue;
+
+        m_connman.ForNode(requests[i].peer, [&](CNode* pnode) {
+            if (result == Result::SEND) {
+                CSerializedNetMsg msg;
+                msg.m_type = results[i].second->type;
+                msg.data = results[i].second->data;
+                m_connman.PushMessage(pnode, std::move(msg));
+            } else if (result == Result::DISCONNECT || !requests[i].noban) {
+                pnode->fDisconnect = true;
+            }
+            return true;
+        });
+    }
+}
 
-static void ProcessGetMWEBUTXOs(CNode& pfrom, const ChainstateManager& chainman, const CChainParams& chainparams, CConnman& connman, const GetMWEBUTXOsMsg& get_utxos)
+static void ProcessGetMWEBUTXOs(CNode& pfrom, MWEBRequestPool& mweb_requests, const GetMWEBUTXOsMsg& get_utxos)
 {
     if (get_utxos.num_requested > MAX_REQUESTED_MWEB_UTXOS) {
         LogPrint(BCLog::NET, "getmwebutxos num_requested %u > %u, disconnect peer=%d\n", get_utxos.num_requested, MAX_REQUESTED_MWEB_UTXOS, pfrom.GetId());
@@ -1845,90 +2116,18 @@ static void ProcessGetMWEBUTXOs(CNode& pfrom, const ChainstateManager& chainman,
         return;
     }
 
-    LOCK(cs_main);
-
-    if (chainman.ActiveChainstate().IsInitialBlockDownload()) {
-        LogPrint(BCLog::NET, "Ignoring getmwebutxos from peer=%d because node is in initial block download\n", pfrom.GetId());
-        return;
-    }
-
-    CBlockIndex* pindex = LookupBlockIndex(get_utxos.block_hash);
-    if (!pindex || !chainman.ActiveChain().Contains(pindex)) {
-        LogPrint(BCLog::NET, "Ignoring getmwebutxos from peer=%d because requested block hash is not in active chain\n", pfrom.GetId());
-        return;
-    }
-
-    // TODO: Add an outbound limit
-
-    // For performance reasons, we limit how many blocks can be undone in order to rebuild the leafset
-    if (chainman.ActiveChain().Tip()->nHeight - pindex->nHeight > MAX_MWEB_LEAFSET_DEPTH) {
-        LogPrint(BCLog::NET, "Ignore getmwebutxos below MAX_MWEB_LEAFSET_DEPTH threshold from peer=%d\n", pfrom.GetId());
-
-        if (!pfrom.HasPermission(PF_NOBAN)) {
-            pfrom.fDisconnect = true;
-        }
-
-        return;
-    }
-
-    // Pruned nodes may have deleted the block, so check whether it's available before trying to send.
-    if (!(pindex->nStatus & BLOCK_HAVE_DATA) || !(pindex->nStatus & BLOCK_HAVE_MWEB)) {
-        LogPrint(BCLog::NET, "Ignoring getmwebutxos request from peer=%d because block is either pruned or lacking mweb data\n", pfrom.GetId());
-
-        if (!pfrom.HasPermission(PF_NOBAN)) {
-            pfrom.fDisconnect = true;
-        }
-        return;
-    }
-
-    // Rewind leafset to block height
-    BlockValidationState state;
-    CCoinsViewCache temp_view(&chainman.ActiveChainstate().CoinsTip());
-    if (!ActivateArbitraryChain(state, temp_view, chainparams, pindex)) {
-        pfrom.fDisconnect = true;
-        return;
-    }
-
-    auto mweb_cache = temp_view.GetMWEBCacheView();
-
-    mmr::Segment segment = mmr::SegmentFactory::Assemble(
-        *mweb_cache->GetOutputPMMR(),
-        *mweb_cache->GetLeafSet(),
-        mmr::LeafIndex::At(get_utxos.start_index),
-        get_utxos.num_requested
-    );
-    if (segment.leaves.empty()) {
-        LogPrint(BCLog::NET, "Could not build segment requested by getmwebutxos from peer=%d\n", pfrom.GetId());
-        pfrom.fDisconnect = true;
-        return;
-    }
-
-    std::vector<NetUTXO> utxos;
-    utxos.reserve(segment.leaves.size());
-    for (const mmr::Leaf& leaf : segment.leaves) {
-        UTXO::CPtr utxo = mweb_cache->GetUTXO(leaf.vec());
-        if (!utxo) {
-            LogPrint(BCLog::NET, "Could not build segment requested by getmwebutxos from peer=%d\n", pfrom.GetId());
-            pfrom.fDisconnect = true;
-            return;
-        }
-
-        utxos.push_back(NetUTXO(get_utxos.output_format, utxo));
+    MWEBRequest request{pfrom.GetId(), pfrom.GetCommonVersion(), pfrom.HasPermission(PF_NOBAN), get_utxos.block_hash, get_utxos};
+    if (!mweb_requests.Enqueue(std::move(request))) {
+        LogPrint(BCLog::NET, "Ignoring getmwebutxos from peer=%d because too many mweb requests are queued\n", pfrom.GetId());
     }
+}
 
-    std::vector<mw::Hash> proof_hashes = segment.hashes;
-    if (segment.lower_peak) {
-        proof_hashes.push_back(*segment.lower_peak);
+static void ProcessGetMWEBLeafset(CNode& pfrom, MWEBRequestPool& mweb_requests, const CInv& inv)
+{
+    MWEBRequest request{pfrom.GetId(), pfrom.GetCommonVersion(), pfrom.HasPermission(PF_NOBAN), inv.hash, nullopt};
+    if (!mweb_requests.Enqueue(std::move(request))) {
+        LogPrint(BCLog::NET, "Ignoring mweb leafset request from peer=%d because too many mweb requests are queued\n", pfrom.GetId());
     }
-
-    MWEBUTXOsMsg utxos_msg{
-        get_utxos.block_hash,
-        get_utxos.start_index,
-        get_utxos.output_format,
-        std::move(utxos),
-        std::move(proof_hashes)
-    };
-    connman.PushMessage(&pfrom, CNetMsgMaker(pfrom.GetCommonVersion()).Make(NetMsgType::MWEBUTXOS, utxos_msg));
 }
 
 //! Determine whether or not a peer can request a transaction, and return it (or nullptr if not found or not allowed).
@@ -1959,7 +2158,7 @@ static CTransactionRef FindTxForGetData(const CTxMemPool& mempool, const CNode&
     return {};
 }
 
-void static ProcessGetData(CNode& pfrom, Peer& peer, const ChainstateManager& chainman, const CChainParams& chainparams, CConnman& connman, CTxMemPool& mempool, const std::atomic<bool>& interruptMsgProc) EXCLUSIVE_LOCKS_REQUIRED(!cs_main, peer.m_getdata_requests_mutex)
+void static ProcessGetData(CNode& pfrom, Peer& peer, const ChainstateManager& chainman, const CChainParams& chainparams, CConnman& connman, CTxMemPool& mempool, MWEBRequestPool& mweb_requests, const std::atomic<bool>& interruptMsgProc) EXCLUSIVE_LOCKS_REQUIRED(!cs_main, peer.m_getdata_requests_mutex)
 {
     AssertLockNotHeld(cs_main);
 
@@ -2028,7 +2227,7 @@ void static ProcessGetData(CNode& pfrom, Peer& peer, const ChainstateManager& ch
         if (inv.IsGenBlkMsg()) {
             ProcessGetBlockData(pfrom, chainparams, inv, connman);
         } else if (inv.IsMsgMWEBLeafset()) {
-            ProcessGetMWEBLeafset(pfrom, chainman, chainparams, inv, connman);
+            ProcessGetMWEBLeafset(pfrom, mweb_requests, inv);
         }
         // else: If the first item on the queue is an unknown type, we erase it
         // and continue processing the queue on the next call.
@@ -3128,7 +3327,7 @@ void PeerManager::ProcessMessage(CNode& pfrom, const std::string& msg_type, CDat
         {
             LOCK(peer->m_getdata_requests_mutex);
             peer->m_getdata_requests.insert(peer->m_getdata_requests.end(), vInv.begin(), vInv.end());
-            ProcessGetData(pfrom, *peer, m_chainman, m_chainparams, m_connman, m_mempool, interruptMsgProc);
+            ProcessGetData(pfrom, *peer, m_chainman, m_chainparams, m_connman, m_mempool, *m_mweb_requests, interruptMsgProc);
         }
 
         return;
@@ -4172,7 +4371,7 @@ void PeerManager::ProcessMessage(CNode& pfrom, const std::string& msg_type, CDat
     if (msg_type == NetMsgType::GETMWEBUTXOS) {
         GetMWEBUTXOsMsg get_utxos;
         vRecv >> get_utxos;
-        ProcessGetMWEBUTXOs(pfrom, m_chainman, m_chainparams, m_connman, get_utxos);
+        ProcessGetMWEBUTXOs(pfrom, *m_mweb_requests, get_utxos);
         return;
     }
 
@@ -4233,7 +4432,7 @@ bool PeerManager::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptMsgP
     {
         LOCK(peer->m_getdata_requests_mutex);
         if (!peer->m_getdata_requests.empty()) {
-            ProcessGetData(*pfrom, *peer, m_chainman, m_chainparams, m_connman, m_mempool, interruptMsgProc);
+            ProcessGetData(*pfrom, *peer, m_chainman, m_chainparams, m_connman, m_mempool, *m_mweb_requests, interruptMsgProc);
         }
     }
 
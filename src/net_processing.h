@@ -18,6 +18,7 @@ class CBlockHeader;
 class CChainParams;
 class CTxMemPool;
 class ChainstateManager;
+class MWEBRequestPool;
 class TxValidationState;
 
 extern RecursiveMutex cs_main;
@@ -36,6 +37,7 @@ class PeerManager final : public CValidationInterface, public NetEventsInterface
 public:
     PeerManager(const CChainParams& chainparams, CConnman& connman, BanMan* banman,
                 CScheduler& scheduler, ChainstateManager& chainman, CTxMemPool& pool);
+    ~PeerManager();
 
     /**
      * Overridden from CValidationInterface.
@@ -141,6 +143,8 @@ private:
     ChainstateManager& m_chainman;
     CTxMemPool& m_mempool;
     TxRequestTracker m_txrequest GUARDED_BY(::cs_main);
+    /** Builds the MWEB leafsets and UTXO segments requested by peers, off the message handler thread. */
+    std::unique_ptr<MWEBRequestPool> m_mweb_requests;
 
     int64_t m_stale_tip_check_time; //!< Next time to check for stale tip
 };
@@ -12,6 +12,7 @@
 
 class ArgsManager;
 class BanMan;
+class BlockTemplateCache;
 class CConnman;
 class CScheduler;
 class CTxMemPool;
@@ -47,6 +48,7 @@ struct NodeContext {
     //! opened by the gui.
     interfaces::WalletClient* wallet_client{nullptr};
     std::unique_ptr<CScheduler> scheduler;
+    std::unique_ptr<BlockTemplateCache> block_template_cache;
     std::function<void()> rpc_interruption_point = [] {};
 
     //! Declare default constructor and destructor that are not inline, so code
@@ -107,6 +107,15 @@ static RPCHelpMan getnetworkhashps()
     };
 }
 
+/** Create a template paying to scriptPubKey, through the node's shared template cache when there is one */
+static std::unique_ptr<CBlockTemplate> CreateBlockTemplate(const NodeContext& node, const CTxMemPool& mempool, const CScript& scriptPubKey, int64_t max_age)
+{
+    if (node.block_template_cache) {
+        return node.block_template_cache->Get(scriptPubKey, max_age);
+    }
+    return BlockAssembler(mempool, Params()).CreateNewBlock(scriptPubKey);
+}
+
 static bool GenerateBlock(ChainstateManager& chainman, CBlock& block, uint64_t& max_tries, unsigned int& extra_nonce, uint256& block_hash)
 {
     block_hash.SetNull();
@@ -118,10 +127,7 @@ static bool GenerateBlock(ChainstateManager& chainman, CBlock& block, uint64_t&
 
     CChainParams chainparams(Params());
 
-    while (max_tries > 0 && block.nNonce < std::numeric_limits<uint32_t>::max() && !CheckProofOfWork(block.GetPoWHash(), block.nBits, chainparams.GetConsensus()) && !ShutdownRequested()) {
-        ++block.nNonce;
-        --max_tries;
-    }
+    ScanProofOfWork(&block, max_tries, chainparams.GetConsensus(), GetNumCores());
     if (max_tries == 0 || ShutdownRequested()) {
         return false;
     }
@@ -514,6 +520,29 @@ static std::string gbt_vb_name(const Consensus::DeploymentPos pos) {
     return s;
 }
 
+/**
+ * Long polling: wait until the best block is no longer hashWatchedChain, or
+ * a minute has passed and the mempool changed since nTransactionsUpdatedLast.
+ * Must be called without cs_main held.
+ */
+static void WaitForNewWork(const CTxMemPool& mempool, const uint256& hashWatchedChain, unsigned int nTransactionsUpdatedLast)
+{
+    std::chrono::steady_clock::time_point checktxtime = std::chrono::steady_clock::now() + std::chrono::minutes(1);
+
+    WAIT_LOCK(g_best_block_mutex, lock);
+    while (g_best_block == hashWatchedChain && IsRPCRunning())
+    {
+        if (g_best_block_cv.wait_until(lock, checktxtime) == std::cv_status::timeout)
+        {
+            // Timeout: Check transactions for update
+            // without holding the mempool lock to avoid deadlocks
+            if (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast)
+                break;
+            checktxtime += std::chrono::seconds(10);
+        }
+    }
+}
+
 static RPCHelpMan getblocktemplate()
 {
     return RPCHelpMan{"getblocktemplate",
@@ -701,7 +730,6 @@ static RPCHelpMan getblocktemplate()
     {
         // Wait to respond until either the best block changes, OR a minute has passed and there are more transactions
         uint256 hashWatchedChain;
-        std::chrono::steady_clock::time_point checktxtime;
         unsigned int nTransactionsUpdatedLastLP;
 
         if (lpval.isStr())
@@ -721,22 +749,7 @@ static RPCHelpMan getblocktemplate()
 
         // Release lock while waiting
         LEAVE_CRITICAL_SECTION(cs_main);
-        {
-            checktxtime = std::chrono::steady_clock::now() + std::chrono::minutes(1);
-
-            WAIT_LOCK(g_best_block_mutex, lock);
-            while (g_best_block == hashWatchedChain && IsRPCRunning())
-            {
-                if (g_best_block_cv.wait_until(lock, checktxtime) == std::cv_status::timeout)
-                {
-                    // Timeout: Check transactions for update
-                    // without holding the mempool lock to avoid deadlocks
-                    if (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLastLP)
-                        break;
-                    checktxtime += std::chrono::seconds(10);
-                }
-            }
-        }
+        WaitForNewWork(mempool, hashWatchedChain, nTransactionsUpdatedLastLP);
         ENTER_CRITICAL_SECTION(cs_main);
 
         if (!IsRPCRunning())
@@ -795,7 +808,7 @@ static RPCHelpMan getblocktemplate()
             scriptPubKey = CScript() << OP_TRUE;
         }
 
-        pblocktemplate = BlockAssembler(mempool, Params()).CreateNewBlock(scriptPubKey);
+        pblocktemplate = CreateBlockTemplate(node, mempool, scriptPubKey, DEFAULT_TEMPLATE_REFRESH_INTERVAL);
         if (!pblocktemplate)
             throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
 
@@ -1344,7 +1357,7 @@ static void AuxMiningCheck(const NodeContext& node)
     }
 }
 
-static UniValue AuxMiningCreateBlock(const CScript& scriptPubKey, const CTxMemPool& mempool)
+static UniValue AuxMiningCreateBlock(const NodeContext& node, const CScript& scriptPubKey, const CTxMemPool& mempool)
 {
     LOCK(cs_auxblockCache);
 
@@ -1382,7 +1395,7 @@ static UniValue AuxMiningCreateBlock(const CScript& scriptPubKey, const CTxMemPo
             }
 
             // Create new block with nonce = 0 and extraNonce = 1
-            std::unique_ptr<CBlockTemplate> newBlock = BlockAssembler(mempool, Params()).CreateNewBlock(scriptPubKey);
+            std::unique_ptr<CBlockTemplate> newBlock = CreateBlockTemplate(node, mempool, scriptPubKey, 60);
             if (!newBlock) {
                 throw JSONRPCError(RPC_OUT_OF_MEMORY, "out of memory");
             }
@@ -1448,6 +1461,7 @@ static UniValue AuxMiningCreateBlock(const CScript& scriptPubKey, const CTxMemPo
     result.pushKV("bits", strprintf("%08x", pblock->nBits));
     result.pushKV("height", static_cast<int64_t>(pindexPrev->nHeight + 1));
     result.pushKV("target", ArithToUint256(target).GetHex());
+    result.pushKV("longpollid", pindexPrev->GetBlockHash().GetHex() + ToString(nTransactionsUpdatedLast));
 
     return result;
 }
@@ -1501,6 +1515,7 @@ static RPCHelpMan getauxblock()
                             {RPCResult::Type::STR_HEX, "bits", "compressed target of the block"},
                             {RPCResult::Type::NUM, "height", "height of the block"},
                             {RPCResult::Type::STR_HEX, "target", "target in reversed byte order"},
+                            {RPCResult::Type::STR, "longpollid", "id to wait for new work with createauxblock"},
                         }
                     },
                     RPCResult{"with arguments",
@@ -1533,7 +1548,7 @@ static RPCHelpMan getauxblock()
         if (scriptPubKey.empty()) {
             scriptPubKey = CScript() << OP_TRUE;
         }
-        return AuxMiningCreateBlock(scriptPubKey, mempool);
+        return AuxMiningCreateBlock(node, scriptPubKey, mempool);
     }
 
     /* Submit a block instead. */
@@ -1549,6 +1564,8 @@ static RPCHelpMan createauxblock()
                 "\nCreate a new block and return information required to merge-mine it.\n",
                 {
                     {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "Coinbase transaction payout address"},
+                    {"longpollid", RPCArg::Type::STR, RPCArg::Optional::OMITTED_NAMED_ARG, "Wait until there is new work for a block returned with this id:\n"
+                        "either the tip changed or, after a minute, the mempool did"},
                 },
                 RPCResult{
                     RPCResult::Type::OBJ, "", "",
@@ -1560,6 +1577,7 @@ static RPCHelpMan createauxblock()
                         {RPCResult::Type::STR_HEX, "bits", "compressed target of the block"},
                         {RPCResult::Type::NUM, "height", "height of the block"},
                         {RPCResult::Type::STR_HEX, "target", "target in reversed byte order"},
+                        {RPCResult::Type::STR, "longpollid", "id to pass back as longpollid to wait for new work"},
                     }
                 },
                 RPCExamples{
@@ -1579,8 +1597,17 @@ static RPCHelpMan createauxblock()
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid coinbase payout address");
     }
 
+    if (!request.params[1].isNull()) {
+        // Format: <hashBestChain><nTransactionsUpdatedLast>, as for getblocktemplate
+        const std::string lpstr = request.params[1].get_str();
+        const uint256 hashWatchedChain = ParseHashV(lpstr.substr(0, 64), "longpollid");
+        WaitForNewWork(mempool, hashWatchedChain, atoi64(lpstr.substr(64)));
+        if (!IsRPCRunning())
+            throw JSONRPCError(RPC_CLIENT_NOT_CONNECTED, "Shutting down");
+    }
+
     const CScript scriptPubKey = GetScriptForDestination(dest);
-    return AuxMiningCreateBlock(scriptPubKey, mempool);
+    return AuxMiningCreateBlock(node, scriptPubKey, mempool);
 },
     };
 }
@@ -1667,7 +1694,7 @@ static const CRPCCommand commands[] =
     { "mining",             "getblocksubsidy",        &getblocksubsidy,        {"height"} },
 
     { "mining",             "getauxblock",            &getauxblock,            {"hash", "auxpow"} },
-    { "mining",             "createauxblock",         &createauxblock,         {"address"} },
+    { "mining",             "createauxblock",         &createauxblock,         {"address", "longpollid"} },
     { "mining",             "submitauxblock",         &submitauxblock,         {"hash", "auxpow"} },
 
     { "generating",         "generatetoaddress",      &generatetoaddress,      {"nblocks","address","maxtries"} },
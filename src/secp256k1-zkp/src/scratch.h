@@ -15,6 +15,9 @@ typedef struct secp256k1_scratch_space_struct {
     void *data[SECP256K1_SCRATCH_MAX_FRAMES];
     size_t offset[SECP256K1_SCRATCH_MAX_FRAMES];
     size_t frame_size[SECP256K1_SCRATCH_MAX_FRAMES];
+    /* Size of the buffer held in data[i]. Buffers are kept when a frame is
+     * deallocated, so that reusing the scratch space does not reallocate. */
+    size_t capacity[SECP256K1_SCRATCH_MAX_FRAMES];
     size_t frame;
     size_t max_size;
     const secp256k1_callback* error_callback;
@@ -330,6 +330,20 @@ void run_scratch_tests(void) {
     CHECK(secp256k1_scratch_max_allocation(scratch, 0) == 1000);
     CHECK(secp256k1_scratch_alloc(scratch, 500) == NULL);
 
+    /* A frame that fits in the buffer of a deallocated one reuses it */
+    {
+        void *data;
+        CHECK(secp256k1_scratch_allocate_frame(scratch, 500, 1) == 1);
+        data = scratch->data[0];
+        secp256k1_scratch_deallocate_frame(scratch);
+        CHECK(secp256k1_scratch_allocate_frame(scratch, 200, 1) == 1);
+        CHECK(scratch->data[0] == data);
+        CHECK(secp256k1_scratch_max_allocation(scratch, 0) < 1000 - 200);
+        CHECK(secp256k1_scratch_alloc(scratch, 200) != NULL);
+        CHECK(secp256k1_scratch_alloc(scratch, 200) == NULL);
+        secp256k1_scratch_deallocate_frame(scratch);
+    }
+
     /* cleanup */
     secp256k1_scratch_space_destroy(scratch);
     secp256k1_context_destroy(none);
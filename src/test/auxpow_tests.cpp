@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <auxpow.h>
+#include <auxpowcache.h>
 #include <chainparams.h>
 #include <coins.h>
 #include <consensus/merkle.h>
@@ -452,6 +453,69 @@ BOOST_AUTO_TEST_CASE(auxpow_pow)
     BOOST_CHECK(!CheckAuxPowProofOfWork(block, params));
 }
 
+BOOST_AUTO_TEST_CASE(auxpow_pow_hashes)
+{
+    SelectParams(CBaseChainParams::REGTEST);
+    const Consensus::Params& params = Params().GetConsensus(371337);
+
+    /* A batch mixing plain and auxpow headers must hash exactly like the
+     single-header path, including the multi-lane groups and the tail.  */
+    CAuxpowBuilder builder(5, 42);
+    std::vector<CBlockHeader> headers(21);
+    for (size_t i = 0; i < headers.size(); ++i) {
+        CBlockHeader& block = headers[i];
+        block.SetBaseVersion(2, params.nAuxpowChainId);
+        block.nTime = i;
+        block.nNonce = i * 3;
+        if (i % 3 == 0) {
+            block.SetAuxpowFlag(true);
+            const int index = CAuxPow::getExpectedIndex(7, params.nAuxpowChainId, 3);
+            const std::vector<unsigned char> auxRoot = builder.buildAuxpowChain(block.GetHash(), 3, index);
+            builder.setCoinbase(CScript() << CAuxpowBuilder::buildCoinbaseData(true, auxRoot, 3, 7));
+            builder.parentBlock.nNonce = i;
+            block.SetAuxpow(new CAuxPow(builder.get()));
+        }
+    }
+
+    std::vector<const CBlockHeader*> batch;
+    for (const CBlockHeader& block : headers) batch.push_back(&block);
+    const std::vector<uint256> hashes = GetAuxPowProofOfWorkHashes(batch);
+    BOOST_REQUIRE_EQUAL(hashes.size(), headers.size());
+    for (size_t i = 0; i < headers.size(); ++i) {
+        BOOST_CHECK(hashes[i] == GetAuxPowProofOfWorkHash(headers[i]));
+    }
+    BOOST_CHECK(hashes[0] == headers[0].auxpow->getParentBlockPoWHash());
+    BOOST_CHECK(hashes[1] == headers[1].GetPoWHash());
+}
+
+BOOST_AUTO_TEST_CASE(auxpow_cache)
+{
+    CAuxpowBuilder builder(5, 42);
+    builder.setCoinbase(CScript() << OP_TRUE);
+    const auto auxpow = std::make_shared<CAuxPow>(builder.get());
+    const uint256 a = uint256S("01"), b = uint256S("02"), c = uint256S("03");
+
+    /* Room for two entries: inserting a third evicts the least recently used.  */
+    CAuxPowCache cache;
+    cache.Insert(a, auxpow);
+    const size_t entry_size = cache.Size();
+    BOOST_CHECK(entry_size > ::GetSerializeSize(*auxpow, PROTOCOL_VERSION));
+    cache.SetMaxSize(2 * entry_size + entry_size / 2);
+    cache.Insert(b, auxpow);
+    BOOST_CHECK(cache.Get(a) == auxpow);
+    cache.Insert(c, auxpow);
+    BOOST_CHECK(cache.Get(a) == auxpow);
+    BOOST_CHECK(cache.Get(b) == nullptr);
+    BOOST_CHECK(cache.Get(c) == auxpow);
+
+    cache.Insert(b, nullptr);
+    BOOST_CHECK(cache.Get(b) == nullptr);
+
+    cache.SetMaxSize(0);
+    BOOST_CHECK_EQUAL(cache.Size(), 0U);
+    BOOST_CHECK(cache.Get(a) == nullptr);
+}
+
 /* ************************************************************************** */
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,7 @@
 #include <attributes.h>
 #include <clientversion.h>
 #include <coins.h>
+#include <mw/util/ParallelUtil.h>
 #include <script/standard.h>
 #include <streams.h>
 #include <test/util/setup_common.h>
@@ -913,4 +914,54 @@ BOOST_AUTO_TEST_CASE(ccoins_write)
                     CheckWriteCoins(parent_value, child_value, parent_value, parent_flags, child_flags, parent_flags);
 }
 
+
+BOOST_AUTO_TEST_CASE(ccoins_prefetch)
+{
+    std::unique_ptr<CCoinsViewDB> db = SingleEntryCacheTest::GetCoinsViewDB();
+
+    std::vector<COutPoint> lookups;
+    {
+        CCoinsViewCacheTest cache(db.get());
+        for (uint32_t i = 0; i < 200; i++) {
+            lookups.emplace_back(InsecureRand256(), i);
+            cache.AddCoin(lookups.back(), Coin(CTxOut(i + 1, CScript() << OP_TRUE), 1, false, false), false);
+        }
+        cache.SetBestBlock(InsecureRand256());
+        BOOST_CHECK(cache.Flush());
+    }
+
+    // Lookups for coins that don't exist come back spent
+    for (uint32_t i = 0; i < 200; i++) {
+        lookups.emplace_back(InsecureRand256(), i);
+    }
+
+    // Enough coins to be read on every thread
+    ParallelUtil::SetThreads(4);
+
+    std::vector<Coin> coins;
+    db->GetCoins(lookups, coins);
+    BOOST_REQUIRE_EQUAL(coins.size(), lookups.size());
+    for (size_t i = 0; i < lookups.size(); i++) {
+        BOOST_CHECK_EQUAL(coins[i].IsSpent(), i >= 200);
+        if (i < 200) BOOST_CHECK_EQUAL(coins[i].out.nValue, CAmount(i + 1));
+    }
+
+    CCoinsViewCacheTest cache(db.get());
+    cache.PrefetchCoins(lookups);
+    for (size_t i = 0; i < lookups.size(); i++) {
+        BOOST_CHECK_EQUAL(cache.HaveCoinInCache(lookups[i]), i < 200);
+    }
+    cache.SelfTest();
+
+    // A cache layered on top reads through the one below
+    CCoinsViewCacheTest child(&cache);
+    child.GetCoins(lookups, coins);
+    for (size_t i = 0; i < lookups.size(); i++) {
+        BOOST_CHECK_EQUAL(coins[i].IsSpent(), i >= 200);
+    }
+    child.SelfTest();
+
+    ParallelUtil::SetThreads(1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -9,6 +9,7 @@
 #include <consensus/tx_verify.h>
 #include <miner.h>
 #include <policy/policy.h>
+#include <pow.h>
 #include <script/standard.h>
 #include <txmempool.h>
 #include <uint256.h>
@@ -515,4 +516,69 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     fCheckpointsEnabled = true;
 }
 
+BOOST_AUTO_TEST_CASE(BlockTemplateCache_reuse)
+{
+    BlockTemplateCache cache(*m_node.mempool);
+    const CScript script_a = CScript() << OP_1;
+    const CScript script_b = CScript() << OP_2;
+    const int64_t start = WITH_LOCK(cs_main, return ::ChainActive().Tip()->GetMedianTimePast()) + 1000;
+    SetMockTime(start);
+
+    std::unique_ptr<CBlockTemplate> block_template = cache.Get(script_a, 5);
+    BOOST_REQUIRE(block_template);
+    BOOST_CHECK(block_template->block.vtx[0]->vout[0].scriptPubKey == script_a);
+    BOOST_CHECK_EQUAL(block_template->block.nTime, start);
+    const CAmount reward = block_template->block.vtx[0]->vout[0].nValue;
+
+    // Nothing changed: the cached template is reused for another payout script
+    SetMockTime(start + 10);
+    block_template = cache.Get(script_b, 5);
+    BOOST_REQUIRE(block_template);
+    BOOST_CHECK(block_template->block.vtx[0]->vout[0].scriptPubKey == script_b);
+    BOOST_CHECK_EQUAL(block_template->block.vtx[0]->vout[0].nValue, reward);
+    BOOST_CHECK_EQUAL(block_template->block.nTime, start);
+
+    // The mempool changed: reused while within max_age, rebuilt after
+    m_node.mempool->AddTransactionsUpdated(1);
+    block_template = cache.Get(script_a, 60);
+    BOOST_REQUIRE(block_template);
+    BOOST_CHECK_EQUAL(block_template->block.nTime, start);
+    block_template = cache.Get(script_a, 5);
+    BOOST_REQUIRE(block_template);
+    BOOST_CHECK_EQUAL(block_template->block.nTime, start + 10);
+    BOOST_CHECK(block_template->block.vtx[0]->vout[0].scriptPubKey == script_a);
+
+    SetMockTime(0);
+}
+
+BOOST_AUTO_TEST_CASE(ScanProofOfWork_sequential)
+{
+    const auto consensus = CreateChainParams(*m_node.args, CBaseChainParams::REGTEST)->GetConsensus();
+    CBlockHeader header;
+    header.nVersion = 4;
+    header.hashPrevBlock = InsecureRand256();
+    header.hashMerkleRoot = InsecureRand256();
+    header.nTime = 1600000000;
+    header.nBits = 0x2003ffff; // roughly one in 64 hashes succeeds
+
+    // Reference result from a plain sequential scan
+    CBlockHeader expected = header;
+    while (!CheckProofOfWork(expected.GetPoWHash(), expected.nBits, consensus)) ++expected.nNonce;
+
+    for (int threads : {1, 3}) {
+        CBlockHeader block = header;
+        uint64_t max_tries = 100000;
+        BOOST_CHECK(ScanProofOfWork(&block, max_tries, consensus, threads));
+        BOOST_CHECK_EQUAL(block.nNonce, expected.nNonce);
+        BOOST_CHECK_EQUAL(max_tries, 100000U - expected.nNonce);
+
+        // Running out of tries stops on the next untried nonce
+        block = header;
+        max_tries = expected.nNonce;
+        BOOST_CHECK(!ScanProofOfWork(&block, max_tries, consensus, threads));
+        BOOST_CHECK_EQUAL(block.nNonce, expected.nNonce);
+        BOOST_CHECK_EQUAL(max_tries, 0U);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -31,4 +31,25 @@ BOOST_AUTO_TEST_CASE(scrypt_hashtest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(scrypt_multi)
+{
+    // Hash a batch that exercises every kernel width plus a single-lane tail
+    // and compare each lane against the single-lane implementation.
+    (void) scrypt_detect_multi();
+    const size_t count = 16 + 8 + 4 + 3;
+    std::vector<char> inputs(count * 80);
+    std::vector<char> outputs(count * 32);
+    for (size_t i = 0; i < inputs.size(); i++) {
+        inputs[i] = (char)(i * 13 + 5);
+    }
+    scrypt_1024_1_1_256_multi(inputs.data(), outputs.data(), count);
+
+    char scratchpad[SCRYPT_SCRATCHPAD_SIZE];
+    uint256 expected;
+    for (size_t i = 0; i < count; i++) {
+        scrypt_1024_1_1_256_sp_generic(&inputs[i * 80], BEGIN(expected), scratchpad);
+        BOOST_CHECK(memcmp(&outputs[i * 32], expected.begin(), 32) == 0);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -8,6 +8,7 @@
 #include <node/ui_interface.h>
 #include <pow.h>
 #include <mweb/mweb_db.h>
+#include <mw/util/ParallelUtil.h>
 #include <random.h>
 #include <shutdown.h>
 #include <uint256.h>
@@ -16,6 +17,8 @@
 #include <util/translation.h>
 #include <util/vector.h>
 
+#include <algorithm>
+#include <numeric>
 #include <stdint.h>
 
 static const char DB_COIN = 'C';
@@ -29,6 +32,9 @@ static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
 
+//! Minimum number of coins each thread reads in CCoinsViewDB::GetCoins
+static const size_t MIN_PARALLEL_COIN_READS = 32;
+
 namespace {
 
 struct CoinEntry {
@@ -60,6 +66,34 @@ bool CCoinsViewDB::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     return m_db->Read(CoinEntry(&outpoint), coin);
 }
 
+void CCoinsViewDB::GetCoins(const std::vector<COutPoint>& outpoints, std::vector<Coin>& coins) const {
+    coins.assign(outpoints.size(), Coin());
+
+    // Each read that misses leveldb's block cache waits on the disk, so spread
+    // the reads across threads. Within a thread, read in key order so
+    // neighbouring coins share the blocks they load.
+    std::vector<size_t> order(outpoints.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&outpoints](size_t a, size_t b) { return outpoints[a] < outpoints[b]; });
+
+    ParallelUtil::ForEachChunk(order.size(), MIN_PARALLEL_COIN_READS, [&](size_t begin, size_t end) {
+        std::vector<CoinEntry> keys;
+        keys.reserve(end - begin);
+        for (size_t i = begin; i < end; i++) {
+            keys.emplace_back(&outpoints[order[i]]);
+        }
+
+        std::vector<Coin> values(end - begin);
+        const std::vector<bool> found = m_db->ReadMany(keys, values);
+        for (size_t i = begin; i < end; i++) {
+            if (found[i - begin]) {
+                coins[order[i]] = std::move(values[i - begin]);
+            }
+        }
+        return true;
+    });
+}
+
 bool CCoinsViewDB::HaveCoin(const OutputIndex& index) const {
     if (index.type() == typeid(mw::Hash)) {
         return GetMWEBView()->HasCoin(boost::get<mw::Hash>(index));
@@ -293,10 +327,11 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
                 pindexNew->mweb_header    = diskindex.mweb_header;
                 pindexNew->hogex_hash     = diskindex.hogex_hash;
                 pindexNew->mweb_amount    = diskindex.mweb_amount;
+                pindexNew->hashPoW        = diskindex.hashPoW;
 
                 // Junkcoin: Disable PoW Sanity check while loading block index from disk.
                 // We use the sha256 hash for the block index for performance reasons, which is recorded for later use.
-                // CheckProofOfWork() uses the scrypt hash which is discarded after a block is accepted.
+                // CheckProofOfWork() uses the scrypt hash, which is only kept for entries with BLOCK_HAVE_POW_HASH.
                 // While it is technically feasible to verify the PoW, doing so takes several minutes as it
                 // requires recomputing every PoW hash during every Junkcoin startup.
                 // We opt instead to simply trust the data that is on your local disk.
@@ -20,6 +20,9 @@
 #include <index/txindex.h>
 #include <logging.h>
 #include <logging/timer.h>
+#include <mw/crypto/Bulletproofs.h>
+#include <mw/crypto/Schnorr.h>
+#include <mw/models/tx/TxBody.h>
 #include <mw/node/CoinsView.h>
 #include <mweb/mweb_db.h>
 #include <mweb/mweb_node.h>
@@ -52,6 +55,7 @@
 #include <validationinterface.h>
 #include <warnings.h>
 #include <junkcoin.h>
+#include <auxpowcache.h>
 
 #include <string>
 
@@ -1174,7 +1178,33 @@ static bool WriteBlockToDisk(const CBlock& block, FlatFilePos& pos, const CMessa
     return true;
 }
 
-bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::Params& consensusParams)
+/**
+ * Check the proof of work of a header read back from disk. A null pow_hash is
+ * computed and returned; otherwise it is the hash cached in the block index
+ * and the scrypt is skipped. The caller must compare the block hash against
+ * the index, which ties the cached value to the header that was read; for
+ * auxpow blocks the auxpow itself is still checked against that hash.
+ */
+static bool CheckDiskBlockProofOfWork(const CBlockHeader& block, const Consensus::Params& consensusParams, uint256& pow_hash)
+{
+    if (pow_hash.IsNull()) {
+        pow_hash = GetAuxPowProofOfWorkHash(block);
+    }
+    return CheckAuxPowProofOfWork(block, consensusParams, &pow_hash);
+}
+
+/** Cache a verified proof-of-work hash in the block index so later reads of the block skip the scrypt. */
+static void CacheBlockPoWHash(const CBlockIndex* pindex, const uint256& pow_hash)
+{
+    LOCK(cs_main);
+    CBlockIndex* entry = LookupBlockIndex(pindex->GetBlockHash());
+    if (entry == nullptr || (entry->nStatus & BLOCK_HAVE_POW_HASH)) return;
+    entry->hashPoW = pow_hash;
+    entry->nStatus |= BLOCK_HAVE_POW_HASH;
+    setDirtyBlockIndex.insert(entry);
+}
+
+static bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::Params& consensusParams, uint256& pow_hash)
 {
     block.SetNull();
 
@@ -1192,7 +1222,7 @@ bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::P
     }
 
     // Check the header (use AuxPoW-aware validation)
-    if (!CheckAuxPowProofOfWork(block, consensusParams))
+    if (!CheckDiskBlockProofOfWork(block, consensusParams, pow_hash))
         return error("ReadBlockFromDisk: Errors in block header at %s", pos.ToString());
 
     // Signet only: check block solution
@@ -1203,23 +1233,33 @@ bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::P
     return true;
 }
 
+bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::Params& consensusParams)
+{
+    uint256 pow_hash;
+    return ReadBlockFromDisk(block, pos, consensusParams, pow_hash);
+}
+
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
 {
     FlatFilePos blockPos;
+    uint256 pow_hash;
     {
         LOCK(cs_main);
         blockPos = pindex->GetBlockPos();
+        if (pindex->nStatus & BLOCK_HAVE_POW_HASH) pow_hash = pindex->hashPoW;
     }
+    const bool cached = !pow_hash.IsNull();
 
-    if (!ReadBlockFromDisk(block, blockPos, consensusParams))
+    if (!ReadBlockFromDisk(block, blockPos, consensusParams, pow_hash))
         return false;
     if (block.GetHash() != pindex->GetBlockHash())
         return error("ReadBlockFromDisk(CBlock&, CBlockIndex*): GetHash() doesn't match index for %s at %s",
                 pindex->ToString(), pindex->GetBlockPos().ToString());
+    if (!cached) CacheBlockPoWHash(pindex, pow_hash);
     return true;
 }
 
-bool ReadBlockHeaderFromDisk(CBlockHeader& block, const FlatFilePos& pos, const Consensus::Params& consensusParams)
+static bool ReadBlockHeaderFromDisk(CBlockHeader& block, const FlatFilePos& pos, const Consensus::Params& consensusParams, uint256& pow_hash)
 {
     block.SetNull();
 
@@ -1237,25 +1277,35 @@ bool ReadBlockHeaderFromDisk(CBlockHeader& block, const FlatFilePos& pos, const
     }
 
     // Check the header (use AuxPoW-aware validation)
-    if (!CheckAuxPowProofOfWork(block, consensusParams))
+    if (!CheckDiskBlockProofOfWork(block, consensusParams, pow_hash))
         return error("ReadBlockHeaderFromDisk: Errors in block header at %s", pos.ToString());
 
     return true;
 }
 
+bool ReadBlockHeaderFromDisk(CBlockHeader& block, const FlatFilePos& pos, const Consensus::Params& consensusParams)
+{
+    uint256 pow_hash;
+    return ReadBlockHeaderFromDisk(block, pos, consensusParams, pow_hash);
+}
+
 bool ReadBlockHeaderFromDisk(CBlockHeader& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
 {
     FlatFilePos blockPos;
+    uint256 pow_hash;
     {
         LOCK(cs_main);
         blockPos = pindex->GetBlockPos();
+        if (pindex->nStatus & BLOCK_HAVE_POW_HASH) pow_hash = pindex->hashPoW;
     }
+    const bool cached = !pow_hash.IsNull();
 
-    if (!ReadBlockHeaderFromDisk(block, blockPos, consensusParams))
+    if (!ReadBlockHeaderFromDisk(block, blockPos, consensusParams, pow_hash))
         return false;
     if (block.GetHash() != pindex->GetBlockHash())
         return error("ReadBlockHeaderFromDisk(CBlockHeader&, CBlockIndex*): GetHash() doesn't match index for %s at %s",
                 pindex->ToString(), pindex->GetBlockPos().ToString());
+    if (!cached) CacheBlockPoWHash(pindex, pow_hash);
     return true;
 }
 
@@ -1584,6 +1634,17 @@ void InitScriptExecutionCache() {
             (nElems*sizeof(uint256)) >>20, (nMaxCacheSize*2)>>20, nElems);
 }
 
+void InitMWEBVerificationCache() {
+    // Split evenly between range proofs, signatures and verified transaction elements.
+    // If -maxmwebcachesize is set to zero, the caches are created with the minimum possible size.
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, gArgs.GetArg("-maxmwebcachesize", DEFAULT_MAX_MWEB_CACHE_SIZE) / 3), MAX_MAX_SIG_CACHE_SIZE) * ((size_t) 1 << 20);
+    size_t nProofs = Bulletproofs::SetCacheSize(nMaxCacheSize);
+    size_t nSignatures = Schnorr::SetCacheSize(nMaxCacheSize);
+    size_t nElements = TxBody::SetCacheSize(nMaxCacheSize);
+    LogPrintf("Using %zu MiB for the MWEB verification caches, able to store %zu range proofs, %zu signatures and %zu transaction elements\n",
+            ((nProofs + nSignatures + nElements) * sizeof(uint256)) >> 20, nProofs, nSignatures, nElements);
+}
+
 /**
  * Check whether all of this transaction's input scripts succeed.
  *
@@ -2409,6 +2470,39 @@ CoinsCacheSizeState CChainState::GetCoinsCacheSizeState(
     return CoinsCacheSizeState::OK;
 }
 
+/**
+ * Compact the MWEB output MMR files up to MIN_BLOCKS_TO_KEEP blocks below the tip.
+ * Leaves spent by the blocks above that horizon are kept, so those blocks can still be disconnected.
+ */
+static void CompactMWEBCoins(const CChain& chain, CCoinsViewDB& coins_db)
+{
+    if (chain.Height() <= (int)MIN_BLOCKS_TO_KEEP) return;
+
+    const CBlockIndex* pindex_horizon = chain[chain.Height() - MIN_BLOCKS_TO_KEEP];
+    if (pindex_horizon->mweb_header == nullptr) return;
+
+    auto mweb_view = std::dynamic_pointer_cast<mw::CoinsViewDB>(coins_db.GetMWEBView());
+    if (!mweb_view) return;
+
+    std::vector<mmr::LeafIndex> spent_since_horizon;
+    for (const CBlockIndex* pindex = chain.Tip(); pindex != pindex_horizon; pindex = pindex->pprev) {
+        CBlockUndo blockundo;
+        if (!UndoReadFromDisk(blockundo, pindex)) {
+            LogPrintf("%s: Failed to read undo data for block %s, skipping compaction\n", __func__, pindex->GetBlockHash().ToString());
+            return;
+        }
+
+        if (blockundo.mwundo != nullptr) {
+            for (const UTXO& spent : blockundo.mwundo->GetCoinsSpent()) {
+                spent_since_horizon.push_back(spent.GetLeafIndex());
+            }
+        }
+    }
+
+    LOG_TIME_MILLIS_WITH_CATEGORY("compact MWEB output MMR", BCLog::BENCH);
+    mweb_view->CompactMMR(pindex_horizon->mweb_header, spent_since_horizon);
+}
+
 bool CChainState::FlushStateToDisk(
     const CChainParams& chainparams,
     BlockValidationState &state,
@@ -2525,6 +2619,9 @@ bool CChainState::FlushStateToDisk(
             // Flush the chainstate (which may refer to block index entries).
             if (!CoinsTip().Flush())
                 return AbortNode(state, "Failed to write to coin database");
+            if (gArgs.GetBoolArg("-mwebcompact", DEFAULT_MWEB_COMPACT)) {
+                CompactMWEBCoins(m_chain, CoinsDB());
+            }
             nLastFlush = nNow;
             full_flush_completed = true;
         }
@@ -2693,6 +2790,7 @@ bool CChainState::DisconnectTip(BlockValidationState& state, const CChainParams&
 }
 
 static int64_t nTimeReadFromDisk = 0;
+static int64_t nTimePrefetch = 0;
 static int64_t nTimeConnectTotal = 0;
 static int64_t nTimeFlush = 0;
 static int64_t nTimeChainState = 0;
@@ -2738,6 +2836,27 @@ public:
     }
 };
 
+/** The outpoints spent by a block, excluding those of outputs created within the block itself. */
+static std::vector<COutPoint> GetSpentOutpoints(const CBlock& block)
+{
+    std::set<uint256> block_txids;
+    for (const CTransactionRef& tx : block.vtx) {
+        block_txids.insert(tx->GetHash());
+    }
+
+    std::vector<COutPoint> outpoints;
+    for (const CTransactionRef& tx : block.vtx) {
+        if (tx->IsCoinBase()) continue;
+        for (const CTxIn& txin : tx->vin) {
+            if (block_txids.count(txin.prevout.hash) == 0) {
+                outpoints.push_back(txin.prevout);
+            }
+        }
+    }
+
+    return outpoints;
+}
+
 /**
  * Connect a new block to m_chain. pblock is either nullptr or a pointer to a CBlock
  * corresponding to pindexNew, to bypass loading it again from disk.
@@ -2767,6 +2886,12 @@ bool CChainState::ConnectTip(BlockValidationState& state, const CChainParams& ch
     int64_t nTime3;
     LogPrint(BCLog::BENCH, "  - Load block from disk: %.2fms [%.2fs]\n", (nTime2 - nTime1) * MILLI, nTimeReadFromDisk * MICRO);
     {
+        // Load the coins spent by the block in one parallel batch, rather than
+        // one synchronous database read per cache miss during ConnectBlock.
+        CoinsTip().PrefetchCoins(GetSpentOutpoints(blockConnecting));
+        int64_t nTimePrefetched = GetTimeMicros(); nTimePrefetch += nTimePrefetched - nTime2;
+        LogPrint(BCLog::BENCH, "  - Prefetch inputs: %.2fms [%.2fs]\n", (nTimePrefetched - nTime2) * MILLI, nTimePrefetch * MICRO);
+
         CCoinsViewCache view(&CoinsTip());
         bool rv = ConnectBlock(blockConnecting, state, pindexNew, view, chainparams);
         GetMainSignals().BlockChecked(blockConnecting, state);
@@ -3363,7 +3488,7 @@ void ResetBlockFailureFlags(CBlockIndex *pindex) {
     return ::ChainstateActive().ResetBlockFailureFlags(pindex);
 }
 
-CBlockIndex* BlockManager::AddToBlockIndex(const CBlockHeader& block)
+CBlockIndex* BlockManager::AddToBlockIndex(const CBlockHeader& block, const uint256& pow_hash)
 {
     AssertLockHeld(cs_main);
 
@@ -3375,6 +3500,11 @@ CBlockIndex* BlockManager::AddToBlockIndex(const CBlockHeader& block)
 
     // Construct new block index object
     CBlockIndex* pindexNew = new CBlockIndex(block);
+    g_auxpow_cache.Insert(hash, block.auxpow);
+    if (!pow_hash.IsNull()) {
+        pindexNew->hashPoW = pow_hash;
+        pindexNew->nStatus |= BLOCK_HAVE_POW_HASH;
+    }
     // We assign the sequence id to blocks only when the full data is available,
     // to avoid miners withholding blocks but broadcasting headers, to get a
     // competitive advantage.
@@ -3522,11 +3652,16 @@ static bool FindUndoPos(BlockValidationState &state, int nFile, FlatFilePos &pos
     return true;
 }
 
-static bool CheckBlockHeader(const CBlockHeader& block, BlockValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true)
+/** If pow_hash is set, it supplies the header's precomputed PoW hash and receives the one that was checked. */
+static bool CheckBlockHeader(const CBlockHeader& block, BlockValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, uint256* pow_hash = nullptr)
 {
     // Check proof of work matches claimed amount (use AuxPoW-aware validation)
-    if (fCheckPOW && !CheckAuxPowProofOfWork(block, consensusParams))
-        return state.Invalid(BlockValidationResult::BLOCK_INVALID_HEADER, "high-hash", "proof of work failed");
+    if (fCheckPOW) {
+        uint256 hash = (pow_hash && !pow_hash->IsNull()) ? *pow_hash : GetAuxPowProofOfWorkHash(block);
+        if (!CheckAuxPowProofOfWork(block, consensusParams, &hash))
+            return state.Invalid(BlockValidationResult::BLOCK_INVALID_HEADER, "high-hash", "proof of work failed");
+        if (pow_hash) *pow_hash = hash;
+    }
 
     return true;
 }
@@ -3878,13 +4013,14 @@ static bool ContextualCheckBlock(const CBlock& block, BlockValidationState& stat
     return true;
 }
 
-bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, const uint256& known_pow_hash)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
     uint256 hash = block.GetHash();
     BlockMap::iterator miSelf = m_block_index.find(hash);
     CBlockIndex *pindex = nullptr;
+    uint256 pow_hash = known_pow_hash;
     if (hash != chainparams.GetConsensus().hashGenesisBlock) {
         if (miSelf != m_block_index.end()) {
             // Block header is already known.
@@ -3898,7 +4034,7 @@ bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationS
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus())) {
+        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), true, &pow_hash)) {
             LogPrint(BCLog::VALIDATION, "%s: Consensus::CheckBlockHeader: %s, %s\n", __func__, hash.ToString(), state.ToString());
             return false;
         }
@@ -3958,7 +4094,7 @@ bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationS
         }
     }
     if (pindex == nullptr)
-        pindex = AddToBlockIndex(block);
+        pindex = AddToBlockIndex(block, pow_hash);
 
     if (ppindex)
         *ppindex = pindex;
@@ -3970,12 +4106,32 @@ bool BlockManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationS
 bool ChainstateManager::ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, BlockValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex)
 {
     AssertLockNotHeld(cs_main);
+
+    // Hash the proof of work of all headers we haven't seen yet in one batch
+    // through the multi-lane scrypt kernel, without holding cs_main.
+    std::vector<size_t> unknown;
+    std::vector<const CBlockHeader*> unknown_headers;
+    {
+        LOCK(cs_main);
+        for (size_t i = 0; i < headers.size(); i++) {
+            if (m_blockman.m_block_index.count(headers[i].GetHash())) continue;
+            unknown.push_back(i);
+            unknown_headers.push_back(&headers[i]);
+        }
+    }
+    const std::vector<uint256> unknown_pow_hashes = GetAuxPowProofOfWorkHashes(unknown_headers);
+    std::vector<uint256> pow_hashes(headers.size());
+    for (size_t i = 0; i < unknown.size(); i++) {
+        pow_hashes[unknown[i]] = unknown_pow_hashes[i];
+    }
+
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); i++) {
+            const CBlockHeader& header = headers[i];
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
             bool accepted = m_blockman.AcceptBlockHeader(
-                header, state, chainparams, &pindex);
+                header, state, chainparams, &pindex, pow_hashes[i]);
             ::ChainstateActive().CheckBlockIndex(chainparams.GetConsensus());
 
             if (!accepted) {
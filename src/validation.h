@@ -70,6 +70,10 @@ static const unsigned int MAX_BLOCKFILE_SIZE = 0x8000000; // 128 MiB
 static const int MAX_SCRIPTCHECK_THREADS = 15;
 /** -par default (number of script-checking threads, 0 = auto) */
 static const int DEFAULT_SCRIPTCHECK_THREADS = 0;
+/** -maxmwebcachesize default (MiB shared by the MWEB verification caches) */
+static const int64_t DEFAULT_MAX_MWEB_CACHE_SIZE = 16;
+/** Default for -mwebcompact, compacting the MWEB output MMR files when flushing */
+static const bool DEFAULT_MWEB_COMPACT = false;
 static const int64_t DEFAULT_MAX_TIP_AGE = 24 * 60 * 60;
 static const bool DEFAULT_CHECKPOINTS_ENABLED = true;
 static const bool DEFAULT_TXINDEX = false;
@@ -294,6 +298,9 @@ public:
 /** Initializes the script-execution cache */
 void InitScriptExecutionCache();
 
+/** Sizes the MWEB range proof, signature and transaction element verification caches */
+void InitMWEBVerificationCache();
+
 
 /** Functions for disk access for blocks */
 bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::Params& consensusParams);
@@ -439,7 +446,9 @@ public:
     /** Clear all data members. */
     void Unload() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
-    CBlockIndex* AddToBlockIndex(const CBlockHeader& block) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    /** Create a new block index entry for a given block header. A non-null pow_hash is the verified
+     *  proof-of-work hash of the header and is kept so that disk reads of the block skip the scrypt. */
+    CBlockIndex* AddToBlockIndex(const CBlockHeader& block, const uint256& pow_hash = uint256()) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     /** Create a new block index entry for a given block hash */
     CBlockIndex* InsertBlockIndex(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
@@ -449,12 +458,14 @@ public:
     /**
      * If a block header hasn't already been seen, call CheckBlockHeader on it, ensure
      * that it doesn't descend from an invalid block, and then add it to m_block_index.
+     * A non-null pow_hash is the header's precomputed GetAuxPowProofOfWorkHash().
      */
     bool AcceptBlockHeader(
         const CBlockHeader& block,
         BlockValidationState& state,
         const CChainParams& chainparams,
-        CBlockIndex** ppindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+        CBlockIndex** ppindex,
+        const uint256& pow_hash = uint256()) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     ~BlockManager() {
         Unload();
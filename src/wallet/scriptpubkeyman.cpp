@@ -701,6 +701,24 @@ TransactionError LegacyScriptPubKeyMan::FillPSBT(PartiallySignedTransaction& psb
     return TransactionError::OK;
 }
 
+boost::optional<uint32_t> LegacyScriptPubKeyMan::GetMWEBAddressIndex(const CKeyID& spend_key_id) const
+{
+    LOCK(cs_KeyStore);
+
+    auto it = m_mweb_key_indices.find(spend_key_id);
+    if (it != m_mweb_key_indices.end()) {
+        return it->second;
+    }
+
+    // v0.21.2 incorrectly generated MWEB keys from the pre-split keypool for upgraded wallets.
+    // These keys will not have an mweb_index, so we return CUSTOM_KEY for them.
+    if (mapKeyMetadata.count(spend_key_id) > 0) {
+        return mw::CUSTOM_KEY;
+    }
+
+    return boost::none;
+}
+
 std::unique_ptr<CKeyMetadata> LegacyScriptPubKeyMan::GetMetadata(const CTxDestination& dest) const
 {
     LOCK(cs_KeyStore);
@@ -815,6 +833,9 @@ void LegacyScriptPubKeyMan::LoadKeyMetadata(const CKeyID& keyID, const CKeyMetad
     LOCK(cs_KeyStore);
     UpdateTimeFirstKey(meta.nCreateTime);
     mapKeyMetadata[keyID] = meta;
+    if (meta.mweb_index) {
+        m_mweb_key_indices[keyID] = *meta.mweb_index;
+    }
 }
 
 void LegacyScriptPubKeyMan::LoadScriptMetadata(const CScriptID& script_id, const CKeyMetadata& meta)
@@ -1107,6 +1128,9 @@ CPubKey LegacyScriptPubKeyMan::GenerateNewKey(WalletBatch &batch, CHDChain& hd_c
     assert(secret.VerifyPubKey(pubkey));
 
     mapKeyMetadata[pubkey.GetID()] = metadata;
+    if (metadata.mweb_index) {
+        m_mweb_key_indices[pubkey.GetID()] = *metadata.mweb_index;
+    }
     UpdateTimeFirstKey(nCreationTime);
 
     if (!AddKeyPubKeyWithDB(batch, secret, pubkey)) {
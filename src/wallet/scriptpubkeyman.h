@@ -408,6 +408,10 @@ public:
 
     std::unique_ptr<CKeyMetadata> GetMetadata(const CTxDestination& dest) const override;
 
+    //! Returns the MWEB address index of the key with the given spend pubkey ID,
+    //! mw::CUSTOM_KEY for any other key of the wallet, or boost::none if the key isn't ours.
+    boost::optional<uint32_t> GetMWEBAddressIndex(const CKeyID& spend_key_id) const;
+
     bool CanGetAddresses(const KeyPurpose purpose) const override;
 
     std::unique_ptr<SigningProvider> GetSolvingProvider(const DestinationAddr& dest_addr) const override;
@@ -425,6 +429,10 @@ public:
     // Map from Key ID to key metadata.
     std::map<CKeyID, CKeyMetadata> mapKeyMetadata GUARDED_BY(cs_KeyStore);
 
+    // Map from the Key ID of an MWEB spend pubkey to its address index.
+    // Filled as keys are loaded or generated, so it covers the whole keypool.
+    std::unordered_map<CKeyID, uint32_t, KeyIDHasher> m_mweb_key_indices GUARDED_BY(cs_KeyStore);
+
     // Map from Script ID to key metadata (for watch-only keys).
     std::map<CScriptID, CKeyMetadata> m_script_metadata GUARDED_BY(cs_KeyStore);
 
@@ -1403,20 +1403,17 @@ void CWallet::blockConnected(const CBlock& block, int height)
             }
         }
 
-        mw::Coin mweb_coin;
-        for (const Output& output : block.mweb_block.m_block->GetOutputs()) {
-            if (mweb_wallet->RewindOutput(output, mweb_coin)) {
-                auto wtx = FindWalletTx(output.GetOutputID());
-                if (wtx != nullptr) {
-                    SyncTransaction(wtx->tx, wtx->mweb_wtx_info, {CWalletTx::Status::CONFIRMED, height, block_hash, wtx->m_confirm.nIndex});
-                    transactionRemovedFromMempool(wtx->tx, MemPoolRemovalReason::BLOCK, 0 /* mempool_sequence */);
-                } else {
-                    AddToWallet(
-                        MakeTransactionRef(),
-                        boost::make_optional<MWEB::WalletTxInfo>(mweb_coin),
-                        {CWalletTx::Status::CONFIRMED, height, block_hash, 0}
-                    );
-                }
+        for (const mw::Coin& mweb_coin : mweb_wallet->RewindOutputs(block.mweb_block.m_block->GetOutputs())) {
+            auto wtx = FindWalletTx(mweb_coin.output_id);
+            if (wtx != nullptr) {
+                SyncTransaction(wtx->tx, wtx->mweb_wtx_info, {CWalletTx::Status::CONFIRMED, height, block_hash, wtx->m_confirm.nIndex});
+                transactionRemovedFromMempool(wtx->tx, MemPoolRemovalReason::BLOCK, 0 /* mempool_sequence */);
+            } else {
+                AddToWallet(
+                    MakeTransactionRef(),
+                    boost::make_optional<MWEB::WalletTxInfo>(mweb_coin),
+                    {CWalletTx::Status::CONFIRMED, height, block_hash, 0}
+                );
             }
         }
     }
@@ -1464,16 +1461,14 @@ void CWallet::blockDisconnected(const CBlock& block, int height)
             }
         }
 
-        for (const Output& output : block.mweb_block.m_block->GetOutputs()) {
-            if (mweb_wallet->RewindOutput(output, coin)) {
-                auto wtx = FindWalletTx(output.GetOutputID());
-                if (wtx != nullptr) {
-                    SyncTransaction(
-                        wtx->tx,
-                        wtx->mweb_wtx_info,
-                        {CWalletTx::Status::UNCONFIRMED, /* block height */ 0, /* block hash */ {}, /* index */ 0}
-                    );
-                }
+        for (const mw::Coin& mweb_coin : mweb_wallet->RewindOutputs(block.mweb_block.m_block->GetOutputs())) {
+            auto wtx = FindWalletTx(mweb_coin.output_id);
+            if (wtx != nullptr) {
+                SyncTransaction(
+                    wtx->tx,
+                    wtx->mweb_wtx_info,
+                    {CWalletTx::Status::UNCONFIRMED, /* block height */ 0, /* block hash */ {}, /* index */ 0}
+                );
             }
         }
     }
@@ -2165,26 +2160,23 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
                     }
                 }
 
-                mw::Coin mweb_coin;
-                for (const Output& output : block.mweb_block.m_block->GetOutputs()) {
-                    if (mweb_wallet->RewindOutput(output, mweb_coin)) {
-                        const CWalletTx* wtx = FindWalletTx(mweb_coin.output_id);
-                        if (wtx) {
-                            SyncTransaction(
-                                wtx->tx,
-                                wtx->mweb_wtx_info,
-                                {CWalletTx::Status::CONFIRMED, block_height, block_hash, wtx->m_confirm.nIndex},
-                                fUpdate
-                            );
-                        } else {
-                            AddToWallet(
-                                MakeTransactionRef(),
-                                boost::make_optional<MWEB::WalletTxInfo>(mweb_coin),
-                                {CWalletTx::Status::CONFIRMED, block_height, block_hash, 0},
-                                nullptr,
-                                false
-                            );
-                        }
+                for (const mw::Coin& mweb_coin : mweb_wallet->RewindOutputs(block.mweb_block.m_block->GetOutputs())) {
+                    const CWalletTx* wtx = FindWalletTx(mweb_coin.output_id);
+                    if (wtx) {
+                        SyncTransaction(
+                            wtx->tx,
+                            wtx->mweb_wtx_info,
+                            {CWalletTx::Status::CONFIRMED, block_height, block_hash, wtx->m_confirm.nIndex},
+                            fUpdate
+                        );
+                    } else {
+                        AddToWallet(
+                            MakeTransactionRef(),
+                            boost::make_optional<MWEB::WalletTxInfo>(mweb_coin),
+                            {CWalletTx::Status::CONFIRMED, block_height, block_hash, 0},
+                            nullptr,
+                            false
+                        );
                     }
                 }
 